@@ -0,0 +1,123 @@
+#include <broadcast/utilities/graph.hpp>
+#include <broadcast/utilities/partial_result.hpp>
+#include <broadcast/utilities/protocol.hpp>
+#include <broadcast/utilities/solve_tree.hpp>
+#include <broadcast/utilities/timer.hpp>
+#include <broadcast/utilities/verbose.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace broadcast;
+
+int main(int argc, char* argv[]) {
+    Timer timer;
+
+    std::ios::sync_with_stdio(false);
+    std::cin.tie(nullptr);
+
+    bool verbose = false;
+    bool noOutput = false;
+    std::vector<std::string> partialResultFiles;
+
+    // Parse command line arguments
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;
+        } else if (std::strcmp(argv[i], "--no-output") == 0) {
+            noOutput = true;
+        } else if (argv[i][0] == '-' && argv[i][1] == '-') {
+            std::cerr << "Error: Unknown argument " << argv[i] << std::endl;
+            return 1;
+        } else {
+            partialResultFiles.push_back(argv[i]);
+        }
+    }
+
+    if (partialResultFiles.empty()) {
+        std::cerr << "Usage: " << argv[0] << " <partial result files...> [--verbose] [--no-output] < graph\n";
+        return 1;
+    }
+
+    // Read the graph and the partial results of all shards
+    Graph graph = readGraph();
+
+    std::vector<PartialResult> results;
+    for (const std::string& fileName : partialResultFiles) {
+        std::ifstream in(fileName);
+        if (!in) {
+            std::cerr << "Error: Failed to open " << fileName << ".\n";
+            return 1;
+        }
+        try {
+            results.push_back(readPartialResult(in));
+        } catch (const std::runtime_error& e) {
+            std::cerr << "Error: " << fileName << ": " << e.what() << '\n';
+            return 1;
+        }
+    }
+
+    PartialResult merged;
+    try {
+        merged = mergePartialResults(results);
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Error: " << e.what() << '\n';
+        return 1;
+    }
+
+    if (merged.graphHash != hashGraph(graph)) {
+        std::cerr << "Error: The partial results belong to a different graph.\n";
+        return 1;
+    }
+    try {
+        checkRemoveEdges(merged, graph);
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Error: " << e.what() << '\n';
+        return 1;
+    }
+
+    // Rebuild the protocol on the best spanning tree
+    Adjacency adjacency(graph);
+    BroadcastingProtocol protocol;
+    try {
+        protocol = solveOnTree(graph, merged.removeEdges, adjacency);
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Error: The removed edges do not leave a spanning tree: " << e.what() << '\n';
+        return 1;
+    }
+
+    if ((int) protocol.rounds.size() != merged.rounds || !isValidBroadcastingProtocol(protocol, graph, adjacency)) {
+        std::cerr << "Internal Error: The merged solution does not match its number of rounds.\n";
+        return 1;
+    }
+
+    if (!noOutput) {
+        printBroadcastingProtocol(protocol);
+    }
+
+    bool optimal = merged.completed || merged.rounds == merged.lowerBound;
+    if (!optimal) {
+        std::cerr << "Warning: not all shards completed, the protocol with " << merged.rounds
+                  << " rounds is not proven optimal (lower bound " << merged.lowerBound << ").\n";
+    }
+
+    if (verbose) {
+        printInfo("Number of shards", (int) results.size());
+        printInfo("Spanning tree of best solution", merged.treeIndex);
+        if (optimal) {
+            printInfo("Optimal broadcasting rounds", merged.rounds);
+        }
+        else {
+            printInfo("Best broadcasting rounds found", merged.rounds);
+            printInfo("Lower bound on optimal rounds", merged.lowerBound);
+            printInfo("Optimality gap", merged.rounds - merged.lowerBound);
+        }
+        printInfo("Total merge time", timer.elapsed());
+    }
+
+    return 0;
+}
@@ -2,10 +2,13 @@
 #include <broadcast/utilities/protocol.hpp>
 #include <broadcast/utilities/timer.hpp>
 #include <broadcast/utilities/verbose.hpp>
+#include <broadcast/utilities/partial_result.hpp>
 #include <broadcast/algorithms/cyclomatic.hpp>
 
+#include <fstream>
 #include <iostream>
 #include <cstring>
+#include <stdexcept>
 #include <string>
 
 using namespace broadcast;
@@ -18,6 +21,9 @@ int main(int argc, char* argv[]) {
 
     bool verbose = false;
     bool noOutput = false;
+    bool estimateOnly = false;
+    std::string partialResultFile;
+    CyclomaticOptions options;
 
     // Parse command line arguments
     for (int i = 1; i < argc; ++i) {
@@ -25,17 +31,109 @@ int main(int argc, char* argv[]) {
             verbose = true;
         } else if (std::strcmp(argv[i], "--no-output") == 0) {
             noOutput = true;
+        } else if (std::strcmp(argv[i], "--estimate-only") == 0) {
+            estimateOnly = true;
+        } else if (std::strcmp(argv[i], "--threads") == 0) {
+            if (i + 1 == argc) {
+                std::cerr << "Error: --threads requires a number of threads.\n";
+                return 1;
+            }
+            try {
+                options.numThreads = std::stoi(argv[++i]);
+            } catch (const std::exception&) {
+                std::cerr << "Error: number of threads must be an integer.\n";
+                return 1;
+            }
+            if (options.numThreads < 0) {
+                std::cerr << "Error: number of threads must be non-negative.\n";
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--time-limit") == 0) {
+            if (i + 1 == argc) {
+                std::cerr << "Error: --time-limit requires a number of seconds.\n";
+                return 1;
+            }
+            try {
+                options.timeLimit = std::stod(argv[++i]);
+            } catch (const std::exception&) {
+                std::cerr << "Error: time limit must be a number.\n";
+                return 1;
+            }
+            if (options.timeLimit <= 0) {
+                std::cerr << "Error: time limit must be positive.\n";
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--checkpoint") == 0) {
+            if (i + 1 == argc) {
+                std::cerr << "Error: --checkpoint requires a file name.\n";
+                return 1;
+            }
+            options.checkpointFile = argv[++i];
+        } else if (std::strcmp(argv[i], "--checkpoint-interval") == 0) {
+            if (i + 1 == argc) {
+                std::cerr << "Error: --checkpoint-interval requires a number of seconds.\n";
+                return 1;
+            }
+            try {
+                options.checkpointInterval = std::stod(argv[++i]);
+            } catch (const std::exception&) {
+                std::cerr << "Error: checkpoint interval must be a number.\n";
+                return 1;
+            }
+            if (options.checkpointInterval <= 0) {
+                std::cerr << "Error: checkpoint interval must be positive.\n";
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--resume") == 0) {
+            options.resume = true;
+        } else if (std::strcmp(argv[i], "--shard") == 0) {
+            if (i + 1 == argc) {
+                std::cerr << "Error: --shard requires a shard i/N.\n";
+                return 1;
+            }
+            std::string shard = argv[++i];
+            size_t slash = shard.find('/');
+            try {
+                if (slash == std::string::npos) throw std::invalid_argument(shard);
+                options.shardIndex = std::stoi(shard.substr(0, slash));
+                options.numberOfShards = std::stoi(shard.substr(slash + 1));
+            } catch (const std::exception&) {
+                std::cerr << "Error: shard must be of the form i/N.\n";
+                return 1;
+            }
+            if (options.numberOfShards < 1 || options.shardIndex < 0 || options.shardIndex >= options.numberOfShards) {
+                std::cerr << "Error: shard i/N must satisfy 0 <= i < N.\n";
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--partial-result") == 0) {
+            if (i + 1 == argc) {
+                std::cerr << "Error: --partial-result requires a file name.\n";
+                return 1;
+            }
+            partialResultFile = argv[++i];
         } else {
             std::cerr << "Error: Unknown argument " << argv[i] << std::endl;
             return 1;
         }
     }
 
+    if (options.resume && options.checkpointFile.empty()) {
+        std::cerr << "Error: --resume requires --checkpoint.\n";
+        return 1;
+    }
+
+    if (options.numberOfShards > 1 && partialResultFile.empty() && !estimateOnly) {
+        std::cerr << "Error: --shard requires --partial-result.\n";
+        return 1;
+    }
+
     // Read the graph
     Graph graph = readGraph();
 
-    Timer graphValidationTimer;
-    if (!isSimpleAndConnected(graph)) {
+    // the adjacency lists are shared by the validation, the algorithm and the
+    // validation of the protocol
+    Adjacency adjacency(graph);
+    if (!isSimpleAndConnected(graph, adjacency)) {
         std::cerr << "Error: The given graph is not simple and connected.\n";
         return 1;
     }
@@ -48,11 +146,51 @@ int main(int argc, char* argv[]) {
         printEmptyLine();
     }
 
+    // Only predict the effort of the search
+    if (estimateOnly) {
+        options.verbose = true;
+        estimateCyclomatic(graph, adjacency, options);
+        return 0;
+    }
+
     // Run the chosen algorithm
-    BroadcastingProtocol protocol = algorithmCyclomatic(graph, verbose);
+    options.verbose = verbose;
+    CyclomaticReport report;
+    BroadcastingProtocol protocol;
+    try {
+        protocol = algorithmCyclomatic(graph, adjacency, options, report);
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Error: " << e.what() << '\n';
+        return 1;
+    }
+
+    if (!report.searchCompleted) {
+        std::cerr << "Warning: time limit reached, the protocol with " << report.rounds
+                  << " rounds is not proven optimal (lower bound " << report.lowerBound << ").\n";
+    }
+
+    // the best solution of this shard, to be combined with the other shards by merge
+    if (!partialResultFile.empty()) {
+        PartialResult result;
+        result.graphHash = hashGraph(graph);
+        result.shardIndex = options.shardIndex;
+        result.numberOfShards = options.numberOfShards;
+        result.rounds = report.rounds;
+        result.treeIndex = report.treeIndex;
+        result.lowerBound = report.lowerBound;
+        result.completed = report.searchCompleted;
+        result.removeEdges = report.removeEdges;
+
+        std::ofstream out(partialResultFile);
+        printPartialResult(result, out);
+        if (!out) {
+            std::cerr << "Error: Failed to write the partial result to " << partialResultFile << ".\n";
+            return 1;
+        }
+    }
 
     Timer validateAndPrintTimer;
-    if (!isValidBroadcastingProtocol(protocol, graph)) {
+    if (!isValidBroadcastingProtocol(protocol, graph, adjacency)) {
         std::cerr << "Internal Error: The algorithm constructed an invalid broadcasting protocol.\n";
         return 1;
     }
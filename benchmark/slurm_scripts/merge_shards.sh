@@ -0,0 +1,30 @@
+#!/usr/local_rwth/bin/zsh
+#SBATCH --job-name=merge_shards
+#SBATCH --output=output/merge_shards_%j.txt
+#
+#SBATCH --cpus-per-task=1
+#SBATCH --time=01:00:00
+#SBATCH --partition=c23ms
+#SBATCH --mem-per-cpu=2000
+#
+#SBATCH --mail-type=ALL
+#SBATCH --mail-user=you@example.com
+
+# Merges the partial results written by sharded_search.sh into the optimal protocol.
+
+if [ "$#" -lt 3 ]; then
+    echo "Usage: sbatch $0 <n> <k> <seed>"
+    exit 1
+fi
+
+n="$1"
+k="$2"
+seed="$3"
+
+work_dir="output/sharded_n${n}_k${k}_${seed}"
+graph_file="$work_dir/graph.txt"
+../../build/generate "$n" "$k" "$seed" > "$graph_file"
+
+../../build/merge --verbose "$work_dir"/partial_*.txt < "$graph_file" > "$work_dir/protocol.txt"
+
+rm -f "$graph_file"
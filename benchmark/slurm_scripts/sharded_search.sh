@@ -0,0 +1,49 @@
+#!/usr/local_rwth/bin/zsh
+#SBATCH --job-name=sharded_search
+#SBATCH --output=output/sharded_search_%A_%a.txt
+#
+#SBATCH --array=0-63
+#SBATCH --cpus-per-task=1
+#SBATCH --time=50:00:00
+#SBATCH --partition=c23ms
+#SBATCH --mem-per-cpu=2000
+#SBATCH --requeue
+#
+#SBATCH --mail-type=ALL
+#SBATCH --mail-user=you@example.com
+
+# Searches one graph with an array job, where every task searches its own share
+# of the spanning trees. The tasks do not communicate, they only need a shared
+# file system. After all tasks are done, run merge_shards.sh with the same
+# parameters to pick the optimum, for example:
+#
+#   jobid=$(sbatch --parsable sharded_search.sh 100000 8 452595348213141)
+#   sbatch --dependency=afterok:$jobid merge_shards.sh 100000 8 452595348213141
+
+if [ "$#" -lt 3 ]; then
+    echo "Usage: sbatch $0 <n> <k> <seed>"
+    exit 1
+fi
+
+n="$1"
+k="$2"
+seed="$3"
+
+shard="$SLURM_ARRAY_TASK_ID"
+shards="$SLURM_ARRAY_TASK_COUNT"
+
+work_dir="output/sharded_n${n}_k${k}_${seed}"
+mkdir -p "$work_dir"
+
+# Every task generates the same graph, the generator is deterministic for a fixed seed
+graph_file="$work_dir/graph_${shard}.txt"
+../../build/generate "$n" "$k" "$seed" > "$graph_file"
+
+# A requeued or preempted task continues from its last checkpoint
+../../build/solve --verbose --no-output \
+    --shard "$shard/$shards" \
+    --partial-result "$work_dir/partial_${shard}.txt" \
+    --checkpoint "$work_dir/checkpoint_${shard}.txt" --resume \
+    < "$graph_file" 2>&1
+
+rm -f "$graph_file"
@@ -4,8 +4,56 @@
 #include <broadcast/utilities/protocol.hpp>
 #include <broadcast/utilities/graph.hpp>
 
+#include <string>
+#include <vector>
+
 namespace broadcast {
 
+/**
+ * @brief Options that control how the cyclomatic algorithm searches for a solution.
+ */
+struct CyclomaticOptions {
+    bool verbose = false; // Print extra information and performance diagnostics
+    int numThreads = 1; // Number of threads used in the preprocessing and the search phase (0 = all hardware threads)
+    double timeLimit = 0; // Time budget in seconds, after which the best protocol found so far is returned (0 = no limit)
+    long long spanningTreeLimit = 0; // Only the spanning trees with index < spanningTreeLimit are searched (0 = no limit)
+    std::string checkpointFile; // File the state of the search phase is saved to ("" = no checkpoints)
+    double checkpointInterval = 600; // Seconds between two checkpoints
+    bool resume = false; // Continue the search from checkpointFile, if the file exists
+    int shardIndex = 0; // Only the spanning trees with index % numberOfShards == shardIndex are searched
+    int numberOfShards = 1; // Number of independent processes the search is split into
+};
+
+/**
+ * @brief Describes how good the protocol returned by the cyclomatic algorithm is proven to be.
+ */
+struct CyclomaticReport {
+    int rounds = 0; // Number of rounds of the returned protocol
+    int lowerBound = 0; // Best proven lower bound on the optimal number of rounds
+    bool optimal = true; // Whether the returned protocol is proven to be optimal (rounds == lowerBound)
+    bool searchCompleted = true; // Whether all spanning trees of this shard were searched
+    long long spanningTreesSearched = 0; // Spanning trees of the kernel graph that were searched completely
+    long double spanningTreesTotal = 0; // Number of spanning trees of the kernel graph
+    long long treeIndex = -1; // Index of the spanning tree the protocol was found on (-1 = initial solution)
+    std::vector<int> removeEdges; // Edges of g removed to obtain the tree the protocol is computed on
+};
+
+/**
+ * @brief A prediction of the effort of the search phase of the cyclomatic algorithm.
+ */
+struct CyclomaticEstimate {
+    int kernelSize = 0; // Number of vertices of the kernel graph
+    int lowerBound = 0; // Lower bound on the optimal number of rounds
+    int initialRounds = 0; // Rounds of the initial solution, which the search tries to improve
+    long double spanningTreesTotal = 0; // Number of spanning trees of the kernel graph
+    int spanningTreesSampled = 0; // Random spanning trees that were searched for the estimate
+    double rejectedShare = 0; // Share of the sampled trees that are rejected by their lower bound
+    long double orderingsPerTree = 0; // Mean number of child orderings of a sampled tree that is not rejected, before pruning
+    double secondsPerTree = 0; // Mean time the search spends on a sampled tree
+    double predictedSearchTime = 0; // Predicted time of the search phase in seconds
+    bool sampleInterrupted = false; // Whether a sampled tree ran out of the time budget, so the prediction is too low
+};
+
 /**
  * @brief Solves the broadcasting problem on graphs with small cyclomatic number.
  *
@@ -24,6 +72,102 @@ namespace broadcast {
  */
 BroadcastingProtocol algorithmCyclomatic(const Graph& g, bool verbose = false);
 
+/**
+ * @brief Solves the broadcasting problem on graphs with small cyclomatic number.
+ *
+ * Same as above, but the behaviour of the search is configured by the given options.
+ * The spanning trees of the kernel graph are distributed over options.numThreads
+ * threads. The result does not depend on the number of threads: among all solutions
+ * with the optimal number of rounds, the one found on the spanning tree with the
+ * smallest index is returned.
+ *
+ * @param g The input graph.
+ * @param options The options of the search.
+ *
+ * @return A BroadcastingProtocol object representing the optimal solution.
+ */
+BroadcastingProtocol algorithmCyclomatic(const Graph& g, const CyclomaticOptions& options);
+
+/**
+ * @brief Solves the broadcasting problem on graphs with small cyclomatic number.
+ *
+ * Same as above, and it additionally fills in the given report. If options.timeLimit
+ * is positive and the search phase runs out of time, the search stops and the best
+ * protocol found so far is returned. The report then contains the best lower bound
+ * and the share of the spanning trees that were searched.
+ *
+ * With options.numberOfShards > 1 only a share of the spanning trees is searched, and
+ * the protocol is only optimal among the trees of this shard. The reports of all
+ * shards can be merged into the result of the whole search by comparing
+ * (rounds, treeIndex).
+ *
+ * If options.checkpointFile is set, the state of the search phase is written to it
+ * every options.checkpointInterval seconds and when the search ends. With
+ * options.resume, a search continues from the state in that file.
+ *
+ * @param g The input graph.
+ * @param options The options of the search.
+ * @param report The report about the returned protocol.
+ *
+ * @return A BroadcastingProtocol object representing the best solution found.
+ *
+ * @throws std::runtime_error if the checkpoint can not be read or written, or if it
+ *         belongs to a different graph or shard
+ * @throws std::invalid_argument if the shard is invalid
+ */
+BroadcastingProtocol algorithmCyclomatic(const Graph& g, const CyclomaticOptions& options,
+    CyclomaticReport& report);
+
+/**
+ * @brief Solves the broadcasting problem on graphs with small cyclomatic number.
+ *
+ * Same as above, with the adjacency lists of g already built, so that a caller that
+ * also validates the graph and the protocol builds them only once.
+ *
+ * @param g The input graph.
+ * @param adj The adjacency lists of g.
+ * @param options The options of the search.
+ * @param report The report about the returned protocol.
+ *
+ * @return A BroadcastingProtocol object representing the best solution found.
+ */
+BroadcastingProtocol algorithmCyclomatic(const Graph& g, const Adjacency& adj,
+    const CyclomaticOptions& options, CyclomaticReport& report);
+
+/**
+ * @brief Predicts the effort of the search phase of the cyclomatic algorithm.
+ *
+ * It runs the preprocessing, counts the spanning trees of the kernel graph with the
+ * matrix-tree theorem, and searches a sample of uniformly random spanning trees
+ * against the initial solution, for at most about half a second. The predicted
+ * search time is the mean time per sampled tree times the number of spanning trees
+ * of the shard, divided by options.numThreads. It is the time to prove the initial
+ * solution optimal; a search that finds a solution meeting the lower bound stops
+ * earlier. The sample is fixed, so the estimate is the same on every run.
+ *
+ * @param g The input graph.
+ * @param options The options of the search, of which only the threads and the shard are used.
+ *                With options.verbose, the estimate is printed.
+ *
+ * @return The estimate of the search phase.
+ *
+ * @throws std::invalid_argument if the shard is invalid
+ */
+CyclomaticEstimate estimateCyclomatic(const Graph& g, const CyclomaticOptions& options);
+
+/**
+ * @brief Predicts the effort of the search phase of the cyclomatic algorithm.
+ *
+ * Same as above, with the adjacency lists of g already built.
+ *
+ * @param g The input graph.
+ * @param adj The adjacency lists of g.
+ * @param options The options of the search, as above.
+ *
+ * @return The estimate of the search phase.
+ */
+CyclomaticEstimate estimateCyclomatic(const Graph& g, const Adjacency& adj, const CyclomaticOptions& options);
+
 } // namespace broadcast
 
 #endif // BROADCAST_ALGORITHM_CYCLOMATIC_HPP
@@ -1,6 +1,7 @@
 #ifndef BROADCAST_UTILITIES_GRAPH_HPP
 #define BROADCAST_UTILITIES_GRAPH_HPP
 
+#include <cstdint>
 #include <vector>
 #include <utility>
 #include <string>
@@ -22,6 +23,76 @@ struct Graph {
     bool operator==(const Graph& other) const;
 };
 
+/**
+ * @brief Adjacency lists of a graph in compressed sparse row form.
+ *
+ * The entries of vertex v are at the positions offset[v] to offset[v + 1] - 1 of
+ * neighbour and edgeId: the other end and the index in g.edges of every edge at v,
+ * in the order of g.edges. An edge appears once at each of its ends, and multi-edges
+ * are kept. The whole graph takes three arrays instead of one vector per vertex, so
+ * it is built once and shared by the algorithms and the validators:
+ *
+ * Adjacency adj(g);
+ * for (auto [u, eid] : adj[v]) {
+ *     // the edge eid from v to u
+ * }
+ *
+ * The ends of all edges of g must be vertices of g.
+ *
+ * @complexity Time: O(n + m) to build, with two passes over the edges.
+ * Space: O(n + m).
+ */
+struct Adjacency {
+    std::vector<int> offset;
+    std::vector<int> neighbour;
+    std::vector<int> edgeId;
+
+    // iterates over the pairs (neighbour, edge id) of one vertex
+    class Iterator {
+    public:
+        Iterator(const int* _neighbour, const int* _edgeId) : neighbour(_neighbour), edgeId(_edgeId) {}
+
+        std::pair<int, int> operator*() const { return {*neighbour, *edgeId}; }
+        Iterator& operator++() {
+            ++neighbour;
+            ++edgeId;
+            return *this;
+        }
+        bool operator==(const Iterator& other) const { return neighbour == other.neighbour; }
+        bool operator!=(const Iterator& other) const { return neighbour != other.neighbour; }
+
+    private:
+        const int* neighbour;
+        const int* edgeId;
+    };
+
+    // the entries of one vertex
+    class Range {
+    public:
+        Range(const int* _neighbour, const int* _edgeId, int _count)
+            : neighbour(_neighbour), edgeId(_edgeId), count(_count) {}
+
+        Iterator begin() const { return Iterator(neighbour, edgeId); }
+        Iterator end() const { return Iterator(neighbour + count, edgeId + count); }
+        int size() const { return count; }
+        bool empty() const { return count == 0; }
+        std::pair<int, int> operator[](int i) const { return {neighbour[i], edgeId[i]}; }
+
+    private:
+        const int* neighbour;
+        const int* edgeId;
+        int count;
+    };
+
+    Adjacency() = default;
+    explicit Adjacency(const Graph& g);
+
+    int degree(int v) const { return offset[v + 1] - offset[v]; }
+    Range operator[](int v) const {
+        return Range(neighbour.data() + offset[v], edgeId.data() + offset[v], degree(v));
+    }
+};
+
 /**
  * @brief Reads a graph from an input stream.
  *
@@ -71,6 +142,28 @@ void printGraph(const Graph& g, std::ostream& out = std::cout);
  */
 bool isSimpleAndConnected(const Graph& g);
 
+/**
+ * @brief Verifies if a graph is simple and connected.
+ *
+ * Same as above, with the adjacency lists of g already built.
+ *
+ * @param g The graph to check
+ * @param adj The adjacency lists of g
+ * @return true if the graph is simple and connected, false otherwise
+ */
+bool isSimpleAndConnected(const Graph& g, const Adjacency& adj);
+
+/**
+ * @brief Computes a fingerprint of a graph.
+ *
+ * The hash depends on n, the source and the ordered list of edges, and it is the same
+ * in every run of every program, so it can be stored in files to recognize the graph.
+ *
+ * @param g The graph to hash
+ * @return A 64-bit hash of g
+ */
+uint64_t hashGraph(const Graph& g);
+
 } // namespace broadcast
 
 #endif // BROADCAST_UTILITIES_GRAPH_HPP
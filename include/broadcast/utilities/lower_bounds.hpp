@@ -0,0 +1,73 @@
+#ifndef BROADCAST_UTILITIES_LOWER_BOUNDS_HPP
+#define BROADCAST_UTILITIES_LOWER_BOUNDS_HPP
+
+#include <broadcast/utilities/graph.hpp>
+
+#include <vector>
+
+namespace broadcast {
+
+/**
+ * @brief Computes the distances of all vertices from the source.
+ *
+ * @param g The input graph.
+ *
+ * @return A vector dist, where dist[v] is the number of edges on a shortest path
+ *         from g.s to v (-1 if v is not reachable from g.s).
+ *
+ * Time Complexity: O(n + m)
+ */
+std::vector<int> distancesFromSource(const Graph& g);
+
+/**
+ * @brief Computes the distances of all vertices from the source.
+ *
+ * Same as above, with the adjacency lists of g already built.
+ *
+ * @param g The input graph.
+ * @param adj The adjacency lists of g.
+ *
+ * @return A vector dist as above.
+ */
+std::vector<int> distancesFromSource(const Graph& g, const Adjacency& adj);
+
+/**
+ * @brief Computes ceil(log2(n)), a lower bound on the broadcasting time of any
+ *        graph with n vertices, as the number of informed vertices at most
+ *        doubles in every round.
+ *
+ * @param n The number of vertices (n >= 1).
+ *
+ * @return The smallest integer k such that 2^k >= n.
+ */
+int logarithmicLowerBound(int n);
+
+/**
+ * @brief Computes a lower bound on the minimum broadcasting time of a graph.
+ *
+ * The bound is the maximum of ceil(log2(n)) and the eccentricity of the source,
+ * since every vertex needs at least one round per edge on its shortest path.
+ *
+ * @param g The input graph, which must be connected.
+ *
+ * @return A lower bound on the number of rounds of every broadcasting protocol for g.
+ *
+ * Time Complexity: O(n + m)
+ */
+int broadcastingLowerBound(const Graph& g);
+
+/**
+ * @brief Computes a lower bound on the minimum broadcasting time of a graph.
+ *
+ * Same as above, with the adjacency lists of g already built.
+ *
+ * @param g The input graph, which must be connected.
+ * @param adj The adjacency lists of g.
+ *
+ * @return A lower bound on the number of rounds of every broadcasting protocol for g.
+ */
+int broadcastingLowerBound(const Graph& g, const Adjacency& adj);
+
+} // namespace broadcast
+
+#endif // BROADCAST_UTILITIES_LOWER_BOUNDS_HPP
@@ -0,0 +1,88 @@
+#ifndef BROADCAST_UTILITIES_PARTIAL_RESULT_HPP
+#define BROADCAST_UTILITIES_PARTIAL_RESULT_HPP
+
+#include <broadcast/utilities/graph.hpp>
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+namespace broadcast {
+
+/**
+ * @brief The best solution found by one shard of a search that is split over
+ *        several independent processes.
+ *
+ * A solution is a spanning tree of the input graph, given by its removed edges.
+ * Solutions are ranked by their number of rounds and then by the index of the
+ * spanning tree of the search on which they were found, so the shards can be merged
+ * into exactly the solution that a single process would have found.
+ */
+struct PartialResult {
+    uint64_t graphHash = 0; // hashGraph of the input graph
+    int shardIndex = 0; // This shard, between 0 and numberOfShards - 1
+    int numberOfShards = 1; // Number of shards the search is split into
+    int rounds = 0; // Number of rounds of the best solution of this shard
+    long long treeIndex = -1; // Index of the spanning tree the solution was found on (-1 = initial solution)
+    int lowerBound = 0; // Proven lower bound on the optimal number of rounds
+    bool completed = true; // Whether all spanning trees of this shard were searched
+    std::vector<int> removeEdges; // Edges removed from the input graph to obtain the solution
+
+    bool operator==(const PartialResult& other) const;
+};
+
+/**
+ * @brief Reads a partial result from an input stream.
+ *
+ * The input format is:
+ *   graphHash
+ *   shardIndex numberOfShards
+ *   rounds treeIndex lowerBound completed
+ *   m e1 e2 ... em
+ *
+ * where completed is 0 or 1, and e1, ..., em are the removed edges.
+ *
+ * @param in The input stream to read from
+ * @return The parsed PartialResult
+ *
+ * @throws std::runtime_error if the input is malformed, or if a removed edge is
+ *         negative or given twice
+ */
+PartialResult readPartialResult(std::istream& in);
+
+/**
+ * @brief Checks that the removed edges of a partial result fit the graph, so that
+ *        they can be passed to solveOnTree.
+ *
+ * @param result The partial result to check
+ * @param g The graph the partial result belongs to
+ *
+ * @throws std::runtime_error if a removed edge is not an edge of g, or if their
+ *         number is not the cyclomatic number m - n + 1 of g
+ */
+void checkRemoveEdges(const PartialResult& result, const Graph& g);
+
+/**
+ * @brief Prints a partial result to an output stream, in the format of readPartialResult.
+ *
+ * @param result The partial result to print
+ * @param out The output stream to write to
+ */
+void printPartialResult(const PartialResult& result, std::ostream& out);
+
+/**
+ * @brief Merges the partial results of all shards of one search.
+ *
+ * @param results The partial results, exactly one for every shard.
+ * @return The best solution over all shards, as the single shard 0 of 1. It is
+ *         completed if all shards are, and its lower bound is the best lower bound
+ *         of all shards.
+ *
+ * @throws std::runtime_error if the results belong to different graphs or searches,
+ *         or if a shard is missing or given twice
+ */
+PartialResult mergePartialResults(const std::vector<PartialResult>& results);
+
+} // namespace broadcast
+
+#endif // BROADCAST_UTILITIES_PARTIAL_RESULT_HPP
@@ -86,6 +86,20 @@ void printBroadcastingProtocol(const BroadcastingProtocol& bp, std::ostream& out
  */
 bool isValidBroadcastingProtocol(const BroadcastingProtocol& bp, const Graph& g);
 
+/**
+ * @brief Verifies if the broadcasting protocol is valid for a given graph.
+ *
+ * Same as above, with the adjacency lists of g already built.
+ *
+ * @param bp The broadcasting protocol
+ * @param g The underlying graph
+ * @param adj The adjacency lists of g
+ * @return true if the protocol is valid for the graph, false otherwise
+ *
+ * Time Complexity: O(n + m + number of transmissions)
+ */
+bool isValidBroadcastingProtocol(const BroadcastingProtocol& bp, const Graph& g, const Adjacency& adj);
+
 } // namespace broadcast
 
 #endif // BROADCAST_UTILITIES_PROTOCOL_HPP
@@ -17,11 +17,30 @@ namespace broadcast {
  * @return An optimal BroadcastingProtocol
  *
  * @note Assumes the resulting graph (after ignoring edges) is a tree.
+ * Every vertex informs its children by decreasing time needed for their
+ * subtrees and then by vertex, so the protocol only depends on the tree,
+ * not on the order of the edges.
  *
  * Time Complexity: O(m), where m is the number of edges of g.
  */
 BroadcastingProtocol solveOnTree(const Graph& g, const std::vector<int>& ignoreEdges = {});
 
+/**
+ * @brief Computes an optimal broadcasting protocol on a tree.
+ *
+ * Same as above, with the adjacency lists of g already built, so that it can be
+ * called for many sets of ignored edges of the same graph.
+ *
+ * @param g The input graph.
+ * @param ignoreEdges A list of edge indices to ignore.
+ * @param adj The adjacency lists of g, including the ignored edges.
+ *
+ * @return An optimal BroadcastingProtocol
+ *
+ * Time Complexity: O(n + m), where m is the number of edges of g.
+ */
+BroadcastingProtocol solveOnTree(const Graph& g, const std::vector<int>& ignoreEdges, const Adjacency& adj);
+
 } // namespace broadcast
 
 #endif // BROADCAST_UTILITIES_SOLVE_TREE_HPP
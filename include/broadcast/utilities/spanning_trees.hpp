@@ -21,18 +21,35 @@ namespace broadcast {
  *     // process tree
  * }
  *
+ * The trees are grown from a root vertex, one edge at a time, and consecutive trees
+ * share the edges that were added first. nextDirected() returns the edges in this
+ * order, so a caller can update its state for the previous tree instead of starting
+ * over.
+ *
  * @param g The input undirected graph.
+ * @param root The vertex the trees are grown from (0 by default).
  * @complexity Time: O(V + E + EN), where V = number of vertices,
  * E = number of edges, and N = number of spanning trees.
  * Space: O(V + E).
  */
 class SpanningTreeIterator {
 public:
-    SpanningTreeIterator(const Graph& _g);
+    SpanningTreeIterator(const Graph& _g, int root = 0);
 
     bool hasNext() const;
     std::vector<int> next();
 
+    /**
+     * @brief Returns the next spanning tree as directed edges and advances.
+     *
+     * The directed edge 2 * i is the edge i of g from its first to its second end, and
+     * 2 * i + 1 is the same edge the other way round. All edges point away from the
+     * root, and they are in the order in which they were added: the edge into the start
+     * of an edge comes before it. Two consecutive trees share a prefix of this list,
+     * which is usually most of it.
+     */
+    std::vector<int> nextDirected();
+
 private:
     int n, m, r;
     std::vector<std::pair<int, int>> edges;
@@ -54,6 +71,7 @@ private:
     std::vector<int> lastTreeWalkEndTime;
 
     std::vector<std::pair<int, std::vector<std::pair<int, bool>>>> recursionStack;
+    std::vector<std::pair<int, int>> walkStack;
 
     bool isWDescendentOfV(int w, int v);
     void performNewTreeWalk();
@@ -62,6 +80,23 @@ private:
     void advance();
 };
 
+/**
+ * @brief Counts the spanning trees of an undirected multigraph.
+ *
+ * It uses Kirchhoff's matrix tree theorem: the number of spanning trees is the
+ * determinant of the Laplacian matrix of g with one row and column removed.
+ * Parallel edges are counted separately and loops are ignored, just like in
+ * SpanningTreeIterator.
+ *
+ * @param g The input undirected graph.
+ *
+ * @return The number of spanning trees of g (0 if g is not connected). It is
+ *         exact as long as it fits into the mantissa of a long double.
+ *
+ * Time Complexity: O(n^3 + m)
+ */
+long double countSpanningTrees(const Graph& g);
+
 } // namespace broadcast
 
 #endif // BROADCAST_UTILITIES_SPANNING_TREES_HPP
@@ -1,19 +1,33 @@
 #include <broadcast/algorithms/cyclomatic.hpp>
+#include <broadcast/utilities/lower_bounds.hpp>
 #include <broadcast/utilities/spanning_trees.hpp>
 #include <broadcast/utilities/solve_tree.hpp>
 #include <broadcast/utilities/timer.hpp>
 #include <broadcast/utilities/verbose.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstdio>
+#include <fstream>
 #include <functional>
+#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
 #include <queue>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
 #include <vector>
 
 namespace broadcast {
 
-// ============= Main Algorithm starts at line 672 ==================
+// ============= Main Algorithm starts at line 2333 ==================
 
 /**
  * For a given graph, it computes a minimal feedback edge set.
@@ -24,7 +38,7 @@ namespace broadcast {
  * will be included in the minimal feedback edge set.
  */
 std::vector<int> getMinimalFeedbackEdgeSet(const Graph& g,
-        const std::vector<std::vector<std::pair<int, int>>>& adj) {
+        const Adjacency& adj) {
     std::vector<bool> isEdgeInBFSTree(g.edges.size(), false);
 
     std::vector<bool> visited(g.n, false);
@@ -62,7 +76,7 @@ std::vector<int> getMinimalFeedbackEdgeSet(const Graph& g,
  *    vertices in U, are also in U
  */
 std::vector<int> constructU(const Graph& g, 
-        const std::vector<std::vector<std::pair<int, int>>>& adj,
+        const Adjacency& adj,
         const std::vector<int>& S) {
     std::vector<bool> inU(g.n, false);
     inU[g.s] = true;
@@ -124,174 +138,332 @@ struct XYTree {
 };
 
 /**
- * For a given xyTree it computes in linear time a vector bh, where
- * - bh[0][t] = min time to inform y from x when all vertices in the tree must be informed in at most t rounds
- * - bh[1][t] = same but inform x from y
- * - if it is impossible then bh[0/1][t] = g.n
+ * Tables over the times 0, 1, ..., length - 1, as the bh and dh tables of the xyTrees,
+ * stored together in one contiguous list of pieces. The tables are piecewise simple in
+ * the time, so only their pieces are stored: from the time from of a piece until the
+ * next piece, a table has the value value + slope * (t - from) and the edge edge.
+ * A time at or above the length is looked up as the last time.
  */
-std::vector<std::vector<int>> computeBH(const Graph& g,
-        const XYTree& xyTree,
-        std::vector<int> xyPath,
-        const std::vector<std::vector<int>>& children,
-        const std::vector<int>& dp) {
-    std::vector<std::vector<int>> bh(2, std::vector<int>(xyTree.size, g.n));
-
-    for (int j = 0; j < 2; ++j) {
-        int curT = 0;
-
-        for (int k = (int) xyPath.size() - 2; k >= 1; --k) {
-            assert(k < (int) xyPath.size() - 1);
-            int addT = 0;
-            int nxtT = 0;
-            bool inserted = false;
-            for (int c : children[xyPath[k]]) {
-                if (curT > dp[c] && !inserted) {
-                    nxtT = std::max(nxtT, 1 + curT + addT);
-                    addT += 1;
-                    inserted = true;
+class PiecewiseTables {
+public:
+    // appends the table with the given values (and edges, if not empty) and returns
+    // its index
+    int add(const std::vector<int>& values, const std::vector<int>& edges = {}) {
+        for (int t = 0; t < (int) values.size(); ++t) {
+            int edge = edges.empty() ? -1 : edges[t];
+            if (t > 0) {
+                const Piece& last = pieces.back();
+                int slope = t - last.from == 1 ? values[t] - last.value : last.slope;
+                if (edge == last.edge && (slope == 0 || slope == 1)
+                        && values[t] == last.value + slope * (t - last.from)) {
+                    pieces.back().slope = slope;
+                    continue;
                 }
-                nxtT = std::max(nxtT, 1 + dp[c] + addT);
-                addT += 1;
             }
-            if (!inserted) {
+            pieces.push_back({t, values[t], 0, edge});
+        }
+        begin.push_back((int) pieces.size());
+        lengths.push_back((int) values.size());
+        return (int) lengths.size() - 1;
+    }
+
+    int value(int table, int t) const {
+        t = std::min(t, lengths[table] - 1);
+        const Piece& piece = find(table, t);
+        return piece.value + piece.slope * (t - piece.from);
+    }
+
+    int length(int table) const {
+        return lengths[table];
+    }
+
+    int edge(int table, int t) const {
+        return find(table, std::min(t, lengths[table] - 1)).edge;
+    }
+
+    // the smallest value of the table, which is at the start of one of its pieces
+    int minimum(int table) const {
+        int result = pieces[begin[table]].value;
+        for (int i = begin[table]; i < begin[table + 1]; ++i) {
+            result = std::min(result, pieces[i].value);
+        }
+        return result;
+    }
+
+    // whether value(t + 1) <= value(t) + 1 for all t, so that t - value(t) never decreases
+    bool growsByAtMostOne(int table) const {
+        for (int i = begin[table] + 1; i < begin[table + 1]; ++i) {
+            const Piece& last = pieces[i - 1];
+            if (pieces[i].value > last.value + last.slope * (pieces[i].from - 1 - last.from) + 1) return false;
+        }
+        return true;
+    }
+
+    // appends all tables of other, in their order
+    void append(const PiecewiseTables& other) {
+        int offset = (int) pieces.size();
+        pieces.insert(pieces.end(), other.pieces.begin(), other.pieces.end());
+        for (int i = 1; i < (int) other.begin.size(); ++i) {
+            begin.push_back(offset + other.begin[i]);
+        }
+        lengths.insert(lengths.end(), other.lengths.begin(), other.lengths.end());
+    }
+
+    bool equal(int a, int b) const {
+        if (lengths[a] != lengths[b]) return false;
+        if (begin[a + 1] - begin[a] != begin[b + 1] - begin[b]) return false;
+        return std::equal(pieces.begin() + begin[a], pieces.begin() + begin[a + 1],
+            pieces.begin() + begin[b]);
+    }
+
+private:
+    struct Piece {
+        int from, value, slope, edge;
+
+        bool operator==(const Piece& other) const {
+            return from == other.from && value == other.value && slope == other.slope
+                && edge == other.edge;
+        }
+    };
+
+    // most tables have only a few pieces, which are faster to scan than to search
+    const Piece& find(int table, int t) const {
+        int lo = begin[table];
+        int hi = begin[table + 1];
+        if (hi - lo <= 8) {
+            while (pieces[hi - 1].from > t) --hi;
+            return pieces[hi - 1];
+        }
+        auto it = std::upper_bound(pieces.begin() + lo, pieces.begin() + hi, t,
+            [](int time, const Piece& piece) { return time < piece.from; });
+        return *(it - 1);
+    }
+
+    std::vector<Piece> pieces;
+    std::vector<int> begin{0}; // the pieces of table i are begin[i], ..., begin[i + 1] - 1
+    std::vector<int> lengths;
+};
+
+// The peeled children of every vertex after peelTrees, with the children of v in child
+// from offset[v] to offset[v + 1].
+struct PeeledChildren {
+    std::vector<int> offset;
+    std::vector<int> child;
+
+    // the children of one vertex
+    class Range {
+    public:
+        Range(const int* _first, int _count) : first(_first), count(_count) {}
+
+        const int* begin() const { return first; }
+        const int* end() const { return first + count; }
+        int size() const { return count; }
+        bool empty() const { return count == 0; }
+        int operator[](int i) const { return first[i]; }
+
+    private:
+        const int* first;
+        int count;
+    };
+
+    Range operator[](int v) const {
+        return Range(child.data() + offset[v], offset[v + 1] - offset[v]);
+    }
+};
+
+/**
+ * Scratch memory for computeBH and computeDHTimes, so that the threads that compute
+ * the tables of the xyTrees do not allocate memory for every vertex of a path.
+ */
+struct XYTreeScratch {
+    std::vector<int> vt;
+    std::vector<std::vector<int>> ct;
+    std::vector<int> pre;
+    std::vector<int> nxt;
+    std::vector<int> pos;
+};
+
+/**
+ * For a given xyTree, whose path is given from the end that sends, it computes in
+ * linear time a vector bh, where
+ * - bh[t] = min time to inform the other end of the path when all vertices in the tree
+ *   must be informed in at most t rounds
+ * - if it is impossible then bh[t] = g.n
+ * bh[0] of the xyTree is computed on the path from x to y, and bh[1] on the path from y to x.
+ */
+std::vector<int> computeBH(const Graph& g,
+        const XYTree& xyTree,
+        const std::vector<int>& xyPath,
+        const PeeledChildren& children,
+        const std::vector<int>& dp,
+        XYTreeScratch& scratch) {
+    std::vector<int> bh(xyTree.size, g.n);
+    int curT = 0;
+
+    for (int k = (int) xyPath.size() - 2; k >= 1; --k) {
+        assert(k < (int) xyPath.size() - 1);
+        int addT = 0;
+        int nxtT = 0;
+        bool inserted = false;
+        for (int c : children[xyPath[k]]) {
+            if (curT > dp[c] && !inserted) {
                 nxtT = std::max(nxtT, 1 + curT + addT);
                 addT += 1;
+                inserted = true;
             }
-            curT = nxtT;
+            nxtT = std::max(nxtT, 1 + dp[c] + addT);
+            addT += 1;
+        }
+        if (!inserted) {
+            nxtT = std::max(nxtT, 1 + curT + addT);
+            addT += 1;
         }
+        curT = nxtT;
+    }
 
-        int critT = curT + 1;
+    int critT = curT + 1;
 
-        for (int t = 0; t < critT; ++t) {
-            bh[j][t] = g.n;
-        }
+    for (int t = 0; t < critT; ++t) {
+        bh[t] = g.n;
+    }
 
-        curT = 1;
-        for (int k = 1; k < (int) xyPath.size(); ++k) {
-            if (k == (int) xyPath.size() - 1) {
-                bh[j][critT] = curT;
-                break;
-            }
-            std::vector<int> vt;
-            for (int c : children[xyPath[k]]) {
-                vt.push_back(dp[c] + 1);
-            }
-            int timeNeed = 0;
-            for (int l = 0; l < (int) vt.size(); ++l) {
-                timeNeed = std::max(timeNeed, vt[l] + l);
-            }
-            timeNeed += 1;
-            int firstFree = g.n;
-            for (int l = (int) vt.size() - 1; l >= 0; --l) {
-                while (curT + timeNeed + vt[l] > critT && timeNeed >= 0) {
-                    firstFree = timeNeed;
-                    timeNeed -= 1;
-                }
-                if (timeNeed < 0) {
-                    firstFree = g.n;
-                    break;
-                }
+    std::vector<int>& vt = scratch.vt;
+    curT = 1;
+    for (int k = 1; k < (int) xyPath.size(); ++k) {
+        if (k == (int) xyPath.size() - 1) {
+            bh[critT] = curT;
+            break;
+        }
+        vt.clear();
+        for (int c : children[xyPath[k]]) {
+            vt.push_back(dp[c] + 1);
+        }
+        int timeNeed = 0;
+        for (int l = 0; l < (int) vt.size(); ++l) {
+            timeNeed = std::max(timeNeed, vt[l] + l);
+        }
+        timeNeed += 1;
+        int firstFree = g.n;
+        for (int l = (int) vt.size() - 1; l >= 0; --l) {
+            while (curT + timeNeed + vt[l] > critT && timeNeed >= 0) {
+                firstFree = timeNeed;
                 timeNeed -= 1;
             }
-            if (timeNeed >= 0) firstFree = 0;
-            if (curT + firstFree + 1 > critT) {
-                bh[j][critT] = g.n;
+            if (timeNeed < 0) {
+                firstFree = g.n;
                 break;
             }
-            curT += firstFree + 1;
+            timeNeed -= 1;
         }
-
-        for (int t = critT + 1; t < xyTree.size; ++t) {
-            bh[j][t] = (int) xyPath.size() - 1;
+        if (timeNeed >= 0) firstFree = 0;
+        if (curT + firstFree + 1 > critT) {
+            bh[critT] = g.n;
+            break;
         }
+        curT += firstFree + 1;
+    }
 
-        std::reverse(xyPath.begin(), xyPath.end());
+    for (int t = critT + 1; t < xyTree.size; ++t) {
+        bh[t] = (int) xyPath.size() - 1;
     }
 
     return bh;
 }
 
 /**
- * For a given xyTree it computes in linear time the vectors dh and dhRemove, where
- * - dh[0][t] = min time to inform the xyTree when x starts sending at time 0 and y at time t
- * - dh[1][t] = min time to inform the xyTree when y starts sending at time 0 and x at time t
- * - dhRemoveEdge[0/1][t] is the index of an edge on the path from x to y such that the optimal
- *   time dh[0/1][t] is achieved by removing this edge and informing the two resulting subtrees
- *   from x and y in optimal time
+ * For the path of an xyTree, given from one of its ends, it computes in linear time the
+ * vector tx, where tx[j] is the min time to inform the part of the xyTree that remains
+ * connected to the first end when the j-th edge of the path is removed, from the first
+ * end. computeDH combines it for both ends.
  */
-void computeDH(const XYTree& xyTree,
-        std::vector<int> xyPath,
-        const std::vector<int>& pathEdges,
-        const std::vector<std::vector<int>>& children,
+std::vector<int> computeDHTimes(const std::vector<int>& xyPath,
+        int numberOfPathEdges,
+        const PeeledChildren& children,
         const std::vector<int>& dp,
-        std::vector<std::vector<int>>& dh,
-        std::vector<std::vector<int>>& dhRemoveEdge) {
-    std::vector<int> tx(pathEdges.size()), ty(pathEdges.size());
-    tx[0] = ty[0] = 0;
-
-    for (int l = 0; l < 2; ++l) {
-        std::vector<std::vector<int>> ct(pathEdges.size());
-        std::vector<int> pre(pathEdges.size());
-        std::vector<int> nxt(pathEdges.size());
-        std::vector<int> pos(pathEdges.size());
-
-        pre[0] = -1;
-        nxt[0] = -1;
-        pos[0] = -1;
-
-        for (int j = 1; j < (int) pathEdges.size(); ++j) {
-            pre[j] = j - 1;
-            nxt[j - 1] = j;
-            nxt[j] = -1;
-            ct[j - 1].push_back(0);
-            pos[j] = (int) ct[j - 1].size() - 1;
-            for (int i = 0; i < (int) children[xyPath[j]].size(); ++i) {
-                ct[j - 1].back() = std::max(ct[j - 1].back(), dp[children[xyPath[j]][i]] + 1 + i);
-                ct[j].push_back(dp[children[xyPath[j]][i]]);
-            }
-
-            int curJ = j - 1;
-            int curPos = pos[j];
-
-            while (curJ >= 1) {
-                int preJ = pre[curJ];
-                int prePos = pos[curJ];
-                int preVal = ct[preJ][prePos];
-                int addT = curJ - preJ;
-                bool curPosChange = false;
-
-                while (curPos >= 1 && ct[curJ][curPos - 1] <= ct[curJ][curPos]) {
-                    std::swap(ct[curJ][curPos - 1], ct[curJ][curPos]);
-                    ct[preJ][prePos] = std::max(ct[preJ][prePos],  ct[curJ][curPos] + curPos + addT);
-                    assert(pos[nxt[curJ]] == curPos);
-                    pos[nxt[curJ]] -= 1;
-                    curPos -= 1;
-                    curPosChange = true;
-                }
-                ct[preJ][prePos] = std::max(ct[preJ][prePos], ct[curJ][curPos] + curPos + addT);
+        XYTreeScratch& scratch) {
+    std::vector<int> tx(numberOfPathEdges);
+    tx[0] = 0;
+
+    std::vector<std::vector<int>>& ct = scratch.ct;
+    std::vector<int>& pre = scratch.pre;
+    std::vector<int>& nxt = scratch.nxt;
+    std::vector<int>& pos = scratch.pos;
+    if ((int) ct.size() < numberOfPathEdges) ct.resize(numberOfPathEdges);
+    for (int j = 0; j < numberOfPathEdges; ++j) ct[j].clear();
+    pre.assign(numberOfPathEdges, 0);
+    nxt.assign(numberOfPathEdges, 0);
+    pos.assign(numberOfPathEdges, 0);
+
+    pre[0] = -1;
+    nxt[0] = -1;
+    pos[0] = -1;
+
+    for (int j = 1; j < numberOfPathEdges; ++j) {
+        pre[j] = j - 1;
+        nxt[j - 1] = j;
+        nxt[j] = -1;
+        ct[j - 1].push_back(0);
+        pos[j] = (int) ct[j - 1].size() - 1;
+        for (int i = 0; i < (int) children[xyPath[j]].size(); ++i) {
+            ct[j - 1].back() = std::max(ct[j - 1].back(), dp[children[xyPath[j]][i]] + 1 + i);
+            ct[j].push_back(dp[children[xyPath[j]][i]]);
+        }
 
-                if (preJ == 0) break;
-                if (ct[preJ][prePos] == preVal) break;
-                if (prePos >= 1 && ct[preJ][prePos] < ct[preJ][prePos - 1]) break;
+        int curJ = j - 1;
+        int curPos = pos[j];
+
+        while (curJ >= 1) {
+            int preJ = pre[curJ];
+            int prePos = pos[curJ];
+            int preVal = ct[preJ][prePos];
+            int addT = curJ - preJ;
+            bool curPosChange = false;
+
+            while (curPos >= 1 && ct[curJ][curPos - 1] <= ct[curJ][curPos]) {
+                std::swap(ct[curJ][curPos - 1], ct[curJ][curPos]);
+                ct[preJ][prePos] = std::max(ct[preJ][prePos],  ct[curJ][curPos] + curPos + addT);
+                assert(pos[nxt[curJ]] == curPos);
+                pos[nxt[curJ]] -= 1;
+                curPos -= 1;
+                curPosChange = true;
+            }
+            ct[preJ][prePos] = std::max(ct[preJ][prePos], ct[curJ][curPos] + curPos + addT);
 
-                if (curPos == 0 && !curPosChange) {
-                    nxt[preJ] = nxt[curJ];
-                    pre[nxt[curJ]] = pre[curJ];
-                    pos[nxt[curJ]] = pos[curJ];
-                }
+            if (preJ == 0) break;
+            if (ct[preJ][prePos] == preVal) break;
+            if (prePos >= 1 && ct[preJ][prePos] < ct[preJ][prePos - 1]) break;
 
-                curJ = preJ;
-                curPos = prePos;
+            if (curPos == 0 && !curPosChange) {
+                nxt[preJ] = nxt[curJ];
+                pre[nxt[curJ]] = pre[curJ];
+                pos[nxt[curJ]] = pos[curJ];
             }
 
-            tx[j] = 1 + ct[0][0];
+            curJ = preJ;
+            curPos = prePos;
         }
 
-        std::reverse(xyPath.begin(), xyPath.end());
-        std::swap(tx, ty);
+        tx[j] = 1 + ct[0][0];
     }
-    std::reverse(ty.begin(), ty.end());
+    return tx;
+}
 
+/**
+ * For a given xyTree it computes in linear time the vectors dh and dhRemove, where
+ * - dh[0][t] = min time to inform the xyTree when x starts sending at time 0 and y at time t
+ * - dh[1][t] = min time to inform the xyTree when y starts sending at time 0 and x at time t
+ * - dhRemoveEdge[0/1][t] is the index of an edge on the path from x to y such that the optimal
+ *   time dh[0/1][t] is achieved by removing this edge and informing the two resulting subtrees
+ *   from x and y in optimal time
+ * tx is computeDHTimes on the path from x, and ty the same from y, reversed, so that
+ * both are indexed by the edges of the path from x to y.
+ */
+void computeDH(const XYTree& xyTree,
+        const std::vector<int>& pathEdges,
+        const std::vector<int>& tx,
+        const std::vector<int>& ty,
+        std::vector<std::vector<int>>& dh,
+        std::vector<std::vector<int>>& dhRemoveEdge) {
     dh.assign(2, std::vector<int>(xyTree.size));
     dhRemoveEdge.assign(2, std::vector<int>(xyTree.size));
 
@@ -326,6 +498,219 @@ void computeDH(const XYTree& xyTree,
     }
 }
 
+// levels of the peeling with fewer leaves than this are peeled by one thread, since
+// starting the threads would take longer than peeling them
+const int PARALLEL_PEELING_MIN_LEAVES = 1 << 14;
+
+/**
+ * Peels the trees that hang off the vertices of U and off the paths of the xyTrees,
+ * leaf by leaf, where deg[v] is the number of edges at v that are not between two
+ * vertices of U. A vertex that is not in U is peeled once it is a leaf, at the level
+ * dp[v], the time needed to inform its subtree from v. Afterwards deg[v] is 0 for the
+ * peeled vertices and counts the remaining edges of the others, subtreeSize[v] counts
+ * v and its peeled descendants, and children[v] lists the peeled children of every
+ * vertex, by decreasing dp and then by vertex.
+ *
+ * The leaves of one level are never adjacent and none of them becomes a leaf in the
+ * same level, so large levels are shared among numThreads threads. The thread that
+ * removes the last but one edge of a vertex u that is not in U has seen all children of
+ * u peeled, and computes dp[u] and the level at which u is peeled. The result does not
+ * depend on numThreads.
+ */
+void peelTrees(const Graph& g,
+        const Adjacency& adj,
+        const std::vector<int>& positionInU,
+        int numThreads,
+        std::vector<int>& deg,
+        std::vector<int>& dp,
+        std::vector<int>& subtreeSize,
+        PeeledChildren& children) {
+    std::vector<std::atomic<int>> remaining(g.n);
+    std::vector<int> parent(g.n, -1);
+    dp.assign(g.n, -1);
+    subtreeSize.assign(g.n, 1);
+
+    // the leaves v with dp[v] = t form a queue from levelHead[t] to levelTail[t],
+    // linked by nextLeaf
+    std::vector<int> levelHead(g.n, -1);
+    std::vector<int> levelTail(g.n, -1);
+    std::vector<int> nextLeaf(g.n, -1);
+    auto pushLeaf = [&](int v) {
+        int t = dp[v];
+        if (levelTail[t] == -1) levelHead[t] = v;
+        else nextLeaf[levelTail[t]] = v;
+        levelTail[t] = v;
+    };
+
+    for (int v = 0; v < g.n; ++v) {
+        remaining[v].store(deg[v], std::memory_order_relaxed);
+        if (deg[v] == 1 && positionInU[v] == -1) {
+            dp[v] = 0;
+            pushLeaf(v);
+        }
+    }
+
+    // peels the leaves with the given positions in the level and collects the vertices
+    // that become leaves
+    auto peel = [&](const std::vector<int>& leaves, int first, int last,
+            std::vector<int>& newLeaves, std::vector<int>& childNeeds) {
+        for (int i = first; i < last; ++i) {
+            int v = leaves[i];
+            // all other neighbours of a leaf are its children
+            int u = -1;
+            for (auto [w, eid] : adj[v]) {
+                if (parent[w] != v) {
+                    u = w;
+                    break;
+                }
+            }
+            parent[v] = u;
+            remaining[v].store(0, std::memory_order_relaxed);
+            if (remaining[u].fetch_sub(1, std::memory_order_acq_rel) != 2 || positionInU[u] != -1) continue;
+
+            childNeeds.clear();
+            for (auto [w, eid] : adj[u]) {
+                if (parent[w] != u) continue;
+                childNeeds.push_back(dp[w]);
+                subtreeSize[u] += subtreeSize[w];
+            }
+            std::sort(childNeeds.begin(), childNeeds.end(), std::greater<int>());
+            dp[u] = 0;
+            for (int j = 0; j < (int) childNeeds.size(); ++j) {
+                dp[u] = std::max(dp[u], childNeeds[j] + 1 + j);
+            }
+            newLeaves.push_back(u);
+        }
+    };
+
+    numThreads = std::max(1, numThreads);
+    std::vector<std::vector<int>> newLeaves(numThreads);
+    std::vector<std::vector<int>> childNeeds(numThreads);
+    std::vector<int> leaves;
+    for (int t = 0; t < g.n; ++t) {
+        leaves.clear();
+        for (int v = levelHead[t]; v != -1; v = nextLeaf[v]) leaves.push_back(v);
+        if (leaves.empty()) continue;
+        int workers = (int) leaves.size() >= PARALLEL_PEELING_MIN_LEAVES ? numThreads : 1;
+        int share = ((int) leaves.size() + workers - 1) / workers;
+        std::vector<std::thread> threads;
+        for (int w = 1; w < workers; ++w) {
+            threads.emplace_back(peel, std::cref(leaves), std::min(w * share, (int) leaves.size()),
+                std::min((w + 1) * share, (int) leaves.size()), std::ref(newLeaves[w]), std::ref(childNeeds[w]));
+        }
+        peel(leaves, 0, std::min(share, (int) leaves.size()), newLeaves[0], childNeeds[0]);
+        for (std::thread& thread : threads) thread.join();
+
+        for (int w = 0; w < workers; ++w) {
+            for (int u : newLeaves[w]) pushLeaf(u);
+            newLeaves[w].clear();
+        }
+    }
+
+    // counts the peeled children of every vertex, and the children with each dp,
+    // counted from the largest, which is below g.n
+    children.offset.assign(g.n + 1, 0);
+    std::vector<int> firstWithNeed(g.n + 1, 0);
+    for (int v = 0; v < g.n; ++v) {
+        deg[v] = remaining[v].load(std::memory_order_relaxed);
+        if (parent[v] == -1) continue;
+        children.offset[parent[v] + 1] += 1;
+        firstWithNeed[g.n - dp[v]] += 1;
+        if (dp[parent[v]] == -1) subtreeSize[parent[v]] += subtreeSize[v];
+    }
+    for (int v = 0; v < g.n; ++v) {
+        children.offset[v + 1] += children.offset[v];
+        firstWithNeed[v + 1] += firstWithNeed[v];
+    }
+
+    // a counting sort by decreasing dp and then by vertex, which is written into the
+    // lists of the parents in this order
+    std::vector<int> byNeed(children.offset.back());
+    for (int v = 0; v < g.n; ++v) {
+        if (parent[v] == -1) continue;
+        byNeed[firstWithNeed[g.n - 1 - dp[v]]++] = v;
+    }
+    std::vector<int> nextChild(children.offset.begin(), children.offset.end() - 1);
+    children.child.resize(byNeed.size());
+    for (int v : byNeed) {
+        children.child[nextChild[parent[v]]++] = v;
+    }
+}
+
+/**
+ * Computes the bh and dh tables of all xyTrees, given the vertices and edges of their
+ * paths from x to y, and stores them as the tables 2 * i + j of bh and dh. The tables
+ * of different xyTrees are independent, and each xyTree is split into four tasks, so
+ * that even a single long xyTree keeps four threads busy: bh from x and from y, and
+ * computeDHTimes from x and from y. The task that finishes the second of the latter two
+ * combines them into dh. The tasks are handed out to numThreads threads, each with
+ * its own scratch memory, and the tables are appended in the order of the xyTrees.
+ */
+void computeXYTreeTables(const Graph& g,
+        const std::vector<XYTree>& xyTrees,
+        const std::vector<std::vector<int>>& xyPaths,
+        const std::vector<std::vector<int>>& xyPathEdges,
+        const PeeledChildren& children,
+        const std::vector<int>& dp,
+        int numThreads,
+        PiecewiseTables& bh,
+        PiecewiseTables& dh) {
+    int numberOfXYTrees = (int) xyTrees.size();
+    int numberOfTasks = 4 * numberOfXYTrees;
+    std::vector<PiecewiseTables> bhTables(2 * numberOfXYTrees);
+    std::vector<PiecewiseTables> dhTables(numberOfXYTrees);
+    std::vector<std::vector<int>> dhTimes(2 * numberOfXYTrees);
+    std::vector<std::atomic<int>> dhTimesDone(numberOfXYTrees);
+    std::atomic<int> nextTask{0};
+
+    auto work = [&]() {
+        XYTreeScratch scratch;
+        std::vector<int> reversedPath;
+        while (true) {
+            int task = nextTask.fetch_add(1);
+            if (task >= numberOfTasks) break;
+            int i = task / 4;
+            int j = task % 2;
+            const std::vector<int>* path = &xyPaths[i];
+            if (j == 1) {
+                reversedPath.assign(xyPaths[i].rbegin(), xyPaths[i].rend());
+                path = &reversedPath;
+            }
+
+            if (task % 4 < 2) {
+                bhTables[2 * i + j].add(computeBH(g, xyTrees[i], *path, children, dp, scratch));
+                continue;
+            }
+            dhTimes[2 * i + j] = computeDHTimes(*path, (int) xyPathEdges[i].size(), children, dp, scratch);
+            if (dhTimesDone[i].fetch_add(1, std::memory_order_acq_rel) == 0) continue;
+
+            std::vector<int>& tx = dhTimes[2 * i];
+            std::vector<int>& ty = dhTimes[2 * i + 1];
+            std::reverse(ty.begin(), ty.end());
+            std::vector<std::vector<int>> xyDH, xyDHRemoveEdge;
+            computeDH(xyTrees[i], xyPathEdges[i], tx, ty, xyDH, xyDHRemoveEdge);
+            for (int k = 0; k < 2; ++k) {
+                dhTables[i].add(xyDH[k], xyDHRemoveEdge[k]);
+            }
+            std::vector<int>().swap(tx);
+            std::vector<int>().swap(ty);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t < std::min(numThreads, numberOfTasks); ++t) {
+        threads.emplace_back(work);
+    }
+    work();
+    for (std::thread& thread : threads) thread.join();
+
+    for (int i = 0; i < numberOfXYTrees; ++i) {
+        bh.append(bhTables[2 * i]);
+        bh.append(bhTables[2 * i + 1]);
+        dh.append(dhTables[i]);
+    }
+}
+
 /**
  * Finds all xTrees and xyTrees and:
  *
@@ -341,18 +726,27 @@ void computeDH(const XYTree& xyTree,
  *       that x informs any of its xTree neighbours
  *
  * - For all xyTrees it computes the vectors bh and dh which are described
- *   in their own function
+ *   in their own function, and stores them as the tables 2 * i + j of bh and dh,
+ *   where i is the index of the xyTree, and the dh tables with dhRemoveEdge as edges
+ *
+ * - It keeps dp and children of peelTrees, and the inner vertices and the edges of
+ *   the paths of all xyTrees in xyPathVertices and xyPathEdgesInG, for the
+ *   construction of the protocols, see solveOnKernelTree
  */
 void preProcessXTreesAndXYTrees(const Graph& g,
-        const std::vector<std::vector<std::pair<int, int>>>& adj,
+        const Adjacency& adj,
         const std::vector<int>& U,
         const std::vector<int>& positionInU,
+        int numThreads,
         std::vector<int>& timeNeededForXTrees,
         std::vector<std::vector<int>>& freeChildrenPositions,
         std::vector<XYTree>& xyTrees,
-        std::vector<std::vector<std::vector<int>>>& bh, 
-        std::vector<std::vector<std::vector<int>>>& dh,
-        std::vector<std::vector<std::vector<int>>>& dhRemoveEdge) {
+        PiecewiseTables& bh,
+        PiecewiseTables& dh,
+        std::vector<int>& dp,
+        PeeledChildren& children,
+        std::vector<int>& xyPathVertices,
+        std::vector<int>& xyPathEdgesInG) {
     std::vector<int> deg(g.n, 0);
 
     for (int i = 0; i < (int) g.edges.size(); ++i) {
@@ -363,37 +757,8 @@ void preProcessXTreesAndXYTrees(const Graph& g,
         }
     }
 
-    std::vector<std::vector<int>> leavesByTime(g.n);
-    std::vector<std::vector<int>> children(g.n);
-    std::vector<int> dp(g.n, -1);
-    std::vector<int> subtreeSize(g.n, 1);
-
-    for (int v = 0; v < g.n; ++v) {
-        if (deg[v] == 1 && positionInU[v] == -1) {
-            dp[v] = 0;
-            leavesByTime[dp[v]].push_back(v);
-        }
-    }
-
-    for (int t = 0; t < g.n; ++t) {
-        for (int v : leavesByTime[t]) {
-            for (auto [u, eid] : adj[v]) {
-                if (deg[u] == 0) continue;
-                children[u].push_back(v);
-                subtreeSize[u] += subtreeSize[v];
-                deg[u] -= 1;
-                deg[v] -= 1;
-                if (deg[u] == 1 && positionInU[u] == -1) {
-                    std::reverse(children[u].begin(), children[u].end());
-                    dp[u] = 0;
-                    for (int i = 0; i < (int) children[u].size(); ++i) {
-                        dp[u] = std::max(dp[u], dp[children[u][i]] + 1 + i);
-                    }
-                    leavesByTime[dp[u]].push_back(u);
-                }
-            }
-        }
-    }
+    std::vector<int> subtreeSize;
+    peelTrees(g, adj, positionInU, numThreads, deg, dp, subtreeSize, children);
 
     timeNeededForXTrees.resize(U.size());
     freeChildrenPositions.resize(U.size());
@@ -406,8 +771,6 @@ void preProcessXTreesAndXYTrees(const Graph& g,
             freeChildrenPositions[i].push_back(0);
         }
         else {
-            std::reverse(children[u].begin(), children[u].end());
-
             for (int j = 0; j < (int) children[u].size(); ++j) {
                 dp[u] = std::max(dp[u], dp[children[u][j]] + 1 + j);
             }
@@ -427,6 +790,9 @@ void preProcessXTreesAndXYTrees(const Graph& g,
         }
     }
 
+    // the xyTrees are found first, and their tables are computed afterwards
+    std::vector<std::vector<int>> xyPaths;
+    std::vector<std::vector<int>> xyPathEdges;
     int sumXYTreeSizes = 0;
 
     for (int u : U) {
@@ -457,22 +823,18 @@ void preProcessXTreesAndXYTrees(const Graph& g,
             }
             int sz = (int) xyPath.size();
             xyTrees.push_back({xyPath[0], xyPath[1], xyPath[sz - 1], xyPath[sz - 2], xyTreeSize});
-
-            for (int i = 1; i < sz - 1; ++i) {
-                std::reverse(children[xyPath[i]].begin(), children[xyPath[i]].end());
-            }
-
-            bh.push_back(computeBH(g, xyTrees.back(), xyPath, children, dp));
-
-            dh.push_back(std::vector<std::vector<int>>());
-            dhRemoveEdge.push_back(std::vector<std::vector<int>>());
-            computeDH(xyTrees.back(), xyPath, pathEdges, children, dp, dh.back(), dhRemoveEdge.back());
+            xyPathVertices.insert(xyPathVertices.end(), xyPath.begin() + 1, xyPath.end() - 1);
+            xyPathEdgesInG.insert(xyPathEdgesInG.end(), pathEdges.begin(), pathEdges.end());
+            xyPaths.push_back(std::move(xyPath));
+            xyPathEdges.push_back(std::move(pathEdges));
 
             sumXYTreeSizes += xyTreeSize;
         }
     }
 
     assert(sumXYTreeSizes <= g.n + 2 * (int) xyTrees.size());
+
+    computeXYTreeTables(g, xyTrees, xyPaths, xyPathEdges, children, dp, numThreads, bh, dh);
 }
 
 // from a given graph g and a list of vertices U that satisfies the above constraints
@@ -501,290 +863,1789 @@ void constructG2(const Graph& g, const std::vector<int>& U,
     }
 }
 
-void computeInitialCAndUsedXYTrees(const Graph& G2,
-        const std::vector<int>& T2,
-        const std::vector<int>& U,
-        const std::vector<XYTree>& xyTrees,
-        const std::vector<int>& positionInU,
-        std::vector<std::vector<std::pair<int, int>>>& C,
-        std::vector<bool>& usedXYTrees) {
-
-    usedXYTrees.assign(xyTrees.size(), false);
-    C.resize(U.size());
-
-    for (int e2id : T2) {
-        int u = -1;
-        int v = -1;
-        if (e2id < int(G2.edges.size() - xyTrees.size())) {
-            u = U[G2.edges[e2id].first];
-            v = U[G2.edges[e2id].second];
-        }
-        else {
-            u = xyTrees[e2id - (G2.edges.size() - xyTrees.size())].x;
-            v = xyTrees[e2id - (G2.edges.size() - xyTrees.size())].y;
-            usedXYTrees[e2id - (G2.edges.size() - xyTrees.size())] = true;
-        }
-        assert(u != -1);
-        assert(v != -1);
-        assert(positionInU[u] != -1);
-        assert(positionInU[v] != -1);
-        C[positionInU[u]].emplace_back(positionInU[v], e2id);
-        C[positionInU[v]].emplace_back(positionInU[u], e2id);
-    }
-
-    std::function<void(int, int)> dfsBuildC = [&](int v, int par) {
-        for (int i = 0; i < (int) C[v].size(); ++i) {
-            if (C[v][i].first == par) {
-                std::swap(C[v][i], C[v].back());
-                C[v].pop_back();
-                break;
-            }
-        }
-        for (auto [u, eid] : C[v]) {
-            assert(u != par);
-            dfsBuildC(u, v);
-        }
-    };
-
-    dfsBuildC(G2.s, -1);
+/**
+ * The preprocessed data that the search phase works on: the multigraph G2 on the
+ * vertices of U, the xyTrees that correspond to the last edges of G2 together with
+ * their bh and dh tables, and the xTrees of every vertex in U.
+ *
+ * The protocols are constructed from the peeled trees and the kernel tree K, the
+ * subgraph of g on U and the inner vertices of the paths of the xyTrees, in which
+ * the vertex i is U[i] for i < |U|. Every cycle of g lies in K.
+ */
+struct Kernel {
+    Graph G2;
+    std::vector<int> U;
+    std::vector<int> positionInU;
+    std::vector<int> correspondingEdgeInG; // edge of g for every edge of G2 between vertices in U
+    int firstXYTreeEdge; // the edge firstXYTreeEdge + i of G2 corresponds to xyTrees[i]
+    std::vector<XYTree> xyTrees;
+    std::vector<int> timeNeededForXTrees;
+    std::vector<std::vector<int>> freeChildrenPositions;
+    PiecewiseTables bh; // table 2 * i + j is bh[j] of xyTrees[i]
+    PiecewiseTables dh; // table 2 * i + j is dh[j] of xyTrees[i], with dhRemoveEdge[j] as edges
+    std::vector<int> childClass; // smallest interchangeable child edge of every directed edge of G2
+    bool hasInterchangeableChildren = false;
+    std::vector<int> leafSendTime; // see computeLeafSendTimes, for every directed edge of G2
+    std::vector<int> peeledDP; // time needed to inform the subtree of every peeled vertex
+    PeeledChildren peeledChildren; // by decreasing peeledDP, for every vertex of g
+    Graph K;
+    Adjacency adjK;
+    std::vector<int> vertexInG; // for every vertex of K
+    std::vector<int> edgeInG; // for every edge of K
+};
 
-    for (int i = 0; i < (int) xyTrees.size(); ++i) {
-        if (!usedXYTrees[i]) {
-            int u = positionInU[xyTrees[i].x];
-            int v = positionInU[xyTrees[i].y];
-            C[u].emplace_back(v, int(G2.edges.size() - xyTrees.size() + i));
-            C[v].emplace_back(u, int(G2.edges.size() - xyTrees.size() + i));
-        }
+// constructs the kernel tree K from the inner vertices and the edges of the paths of
+// the xyTrees, and from the edges of g between vertices in U
+void constructKernelTree(const Graph& g,
+        const std::vector<int>& xyPathVertices,
+        const std::vector<int>& xyPathEdgesInG,
+        Kernel& kernel) {
+    std::vector<int> positionInK = kernel.positionInU;
+    kernel.vertexInG = kernel.U;
+    for (int v : xyPathVertices) {
+        positionInK[v] = (int) kernel.vertexInG.size();
+        kernel.vertexInG.push_back(v);
     }
 
-    for (int i = 0; i < (int) U.size(); ++i) {
-        std::sort(C[i].begin(), C[i].end());
+    kernel.K.n = (int) kernel.vertexInG.size();
+    kernel.K.s = kernel.positionInU[g.s];
+    kernel.K.edges.clear();
+    kernel.edgeInG = kernel.correspondingEdgeInG;
+    kernel.edgeInG.insert(kernel.edgeInG.end(), xyPathEdgesInG.begin(), xyPathEdgesInG.end());
+    for (int eid : kernel.edgeInG) {
+        auto [u, v] = g.edges[eid];
+        kernel.K.edges.emplace_back(positionInK[u], positionInK[v]);
     }
+    kernel.adjK = Adjacency(kernel.K);
 }
 
-// for a given spanning tree T2 and ordered list of children for every vertex
-// and a given time limit t, it checks if the T2 with the given children orders
-// can be expanded to a valid broadcasting protocol on the whole graph
-bool isFeasible(const Graph& G2,
-        const std::vector<int>& correspondingEdgeInG,
-        const std::vector<bool>& inT2,
-        const std::vector<int>& U,
-        const std::vector<XYTree>& xyTrees,
-        const std::vector<bool>& usedXYTrees,
-        const std::vector<int>& timeNeededForXTrees,
-        const std::vector<std::vector<int>>& freeChildrenPositions,
-        const std::vector<std::vector<std::pair<int, int>>>& C,
-        const std::vector<std::vector<std::vector<int>>>& bh, 
-        const std::vector<std::vector<std::vector<int>>>& dh,
-        const std::vector<std::vector<std::vector<int>>>& dhRemoveEdge,
-        std::vector<int>& curRemoveEdges,
-        int t) {
+// A directed edge 2 * e + d of G2 goes from the first end of the edge e to the second
+// one if d = 0, and the other way round if d = 1. When the end u of such an edge is
+// a child of its start v in T2 and u has no children itself, then u only needs the
+// edge and its own xTrees. Two such children of v are interchangeable if their edges
+// take the same time (both are edges of g, or both are xyTrees with the same bh table
+// in this direction) and their xTrees need the same time. It computes the class of
+// every directed edge, and returns the number of directed edges that are not the
+// smallest of their class.
+int computeChildClasses(Kernel& kernel) {
+    const Graph& G2 = kernel.G2;
+    int numberOfDirectedEdges = 2 * (int) G2.edges.size();
+    std::vector<std::vector<int>> outgoing(G2.n);
+    for (int a = 0; a < numberOfDirectedEdges; ++a) {
+        auto [x, y] = G2.edges[a / 2];
+        outgoing[a % 2 == 0 ? x : y].push_back(a);
+    }
 
-    std::vector<std::pair<int, int>> xyTreesStart(xyTrees.size(), std::make_pair(-1, -1));
-    std::vector<int> r(U.size(), -1);
-    std::function<bool(int)> dfs = [&](int v) {
-        if (r[v] > t) return false;
-        int timeLeft = t - r[v];
-        if (timeLeft < timeNeededForXTrees[v]) return false;
-        int haveExtra = timeLeft - timeNeededForXTrees[v];
-        int usedExtra = 0;
-        int fcPos = 0;
-        int addCounter = 1;
-        for (auto [u, eid] : C[v]) {
-            int addTime = -1;
-            if (usedExtra < haveExtra) {
-                addTime = usedExtra;
-                usedExtra += 1;
-            }
-            else if (fcPos < (int) freeChildrenPositions[v].size()) {
-                addTime = haveExtra + freeChildrenPositions[v][fcPos];
-                fcPos += 1;
-            }
-            else {
-                addTime = haveExtra + freeChildrenPositions[v].back() + addCounter;
-                addCounter += 1;
-            }
-            assert(addTime >= 0);
-            if (eid >= int(G2.edges.size() - xyTrees.size())) {
-                int id = eid - int(G2.edges.size() - xyTrees.size());
-                if (!usedXYTrees[id]) {
-                    if (U[v] == xyTrees[id].x) {
-                        xyTreesStart[id].first = r[v] + addTime;
-                    }
-                    else {
-                        assert(U[v] == xyTrees[id].y);
-                        xyTreesStart[id].second = r[v] + addTime;
-                    }
-                }
-                else {
-                    int j = 0;
-                    if (U[v] != xyTrees[id].x) {
-                        assert(U[v] == xyTrees[id].y);
-                        j = 1;
-                    }
-                    if (r[v] + addTime > t) return false;
-                    assert(0 <= u && u < (int) r.size());
-                    assert(0 <= v && v < (int) r.size());
-                    assert(0 <= id && id < (int) bh.size());
-                    assert(0 <= j && j < (int) bh[id].size());
-                    assert(0 <= t - (r[v] + addTime));
-                    if (t - (r[v] + addTime) < (int) bh[id][j].size()) {
-                        r[u] = r[v] + addTime + bh[id][j][t - (r[v] + addTime)];
-                    }
-                    else {
-                        r[u] = r[v] + addTime + bh[id][j].back();
-                    }
-                    if (!dfs(u)) return false;
-                }
-            }
-            else {
-                r[u] = r[v] + addTime + 1;
-                if (!dfs(u)) return false;
-            }
-        }
-        return true;
+    auto head = [&](int a) {
+        auto [x, y] = G2.edges[a / 2];
+        return a % 2 == 0 ? y : x;
     };
-    r[G2.s] = 0;
-    if (!dfs(G2.s)) return false;
-    curRemoveEdges.clear();
-    for (int i = 0; i < (int) xyTrees.size(); ++i) {
-        if (!usedXYTrees[i]) {
-            auto [t1, t2] = xyTreesStart[i];
-            assert(t1 != -1 && t2 != -1);
-            if (t1 <= t2) {
-                int pos = std::min((int) dh[i][0].size() - 1, t2 - t1);
-                if (t1 + dh[i][0][pos] > t) return false;
-                curRemoveEdges.push_back(dhRemoveEdge[i][0][pos]);
-            }
-            else {
-                int pos = std::min((int) dh[i][1].size() - 1, t1 - t2);
-                if (t2 + dh[i][1][pos] > t) return false;
-                curRemoveEdges.push_back(dhRemoveEdge[i][1][pos]);
+    auto sameTime = [&](int a, int b) {
+        int ida = a / 2 - kernel.firstXYTreeEdge;
+        int idb = b / 2 - kernel.firstXYTreeEdge;
+        if (kernel.timeNeededForXTrees[head(a)] != kernel.timeNeededForXTrees[head(b)]) return false;
+        if (ida < 0 || idb < 0) return ida < 0 && idb < 0;
+        int ja = kernel.U[G2.edges[a / 2].first] == kernel.xyTrees[ida].x ? a % 2 : 1 - a % 2;
+        int jb = kernel.U[G2.edges[b / 2].first] == kernel.xyTrees[idb].x ? b % 2 : 1 - b % 2;
+        return kernel.bh.equal(2 * ida + ja, 2 * idb + jb);
+    };
+
+    int numberOfInterchangeable = 0;
+    kernel.childClass.resize(numberOfDirectedEdges);
+    for (int v = 0; v < G2.n; ++v) {
+        for (int i = 0; i < (int) outgoing[v].size(); ++i) {
+            int a = outgoing[v][i];
+            kernel.childClass[a] = a;
+            for (int j = 0; j < i; ++j) {
+                int b = outgoing[v][j];
+                if (kernel.childClass[b] == b && sameTime(a, b)) {
+                    kernel.childClass[a] = b;
+                    numberOfInterchangeable += 1;
+                    break;
+                }
             }
         }
     }
-    for (int i = 0; i < int(G2.edges.size() - xyTrees.size()); ++i) {
-        if (!inT2[i]) curRemoveEdges.push_back(correspondingEdgeInG[i]);
-    }
-    return true;
+    kernel.hasInterchangeableChildren = numberOfInterchangeable > 0;
+    return numberOfInterchangeable;
 }
 
-// ============= Main Algorithm starts here ==================
+// When the end u of a directed edge 2 * e + d of G2 is a leaf child of its start v in
+// T2, then v has to send to u at least leafSendTime rounds before the time limit, and
+// it is enough if it does. For an edge of g this is 1 + timeNeededForXTrees[u]. For an
+// xyTree it is the smallest remaining time R with R - bh(R) >= timeNeededForXTrees[u],
+// which is a deadline only if R - bh(R) never decreases; otherwise it is -1.
+// Two leaf children with a deadline are exchanged without harm if the one with the
+// earlier deadline is sent first, and this keeps every other child at its send time.
+// So only their order by deadline has to be tried, see childKey.
+void computeLeafSendTimes(Kernel& kernel) {
+    const Graph& G2 = kernel.G2;
+    kernel.leafSendTime.assign(2 * G2.edges.size(), -1);
+    for (int a = 0; a < 2 * (int) G2.edges.size(); ++a) {
+        auto [x, y] = G2.edges[a / 2];
+        int v = a % 2 == 0 ? x : y;
+        int u = a % 2 == 0 ? y : x;
+        int need = kernel.timeNeededForXTrees[u];
+        int id = a / 2 - kernel.firstXYTreeEdge;
+        if (id < 0) {
+            kernel.leafSendTime[a] = need + 1;
+            continue;
+        }
+        int table = 2 * id + (kernel.U[v] == kernel.xyTrees[id].x ? 0 : 1);
+        if (!kernel.bh.growsByAtMostOne(table)) continue;
+        // bh is constant after its last entry, so hi always satisfies the condition
+        int lo = 0;
+        int hi = std::max(kernel.bh.length(table) - 1, need + kernel.bh.value(table, kernel.bh.length(table) - 1));
+        while (lo < hi) {
+            int mid = lo + (hi - lo) / 2;
+            if (mid - kernel.bh.value(table, mid) >= need) hi = mid;
+            else lo = mid + 1;
+        }
+        kernel.leafSendTime[a] = lo;
+    }
+}
 
-BroadcastingProtocol algorithmCyclomatic(const Graph& g, bool verbose) {
-    Timer totalTimer;
+// A list of children (u, eid) that lives in the flat storage of a SearchWorkspace,
+// with room for as many children as the vertex has edges in G2.
+class ChildList {
+public:
+    using Child = std::pair<int, int>;
 
-    if (verbose) {
-        printHeader("Running the cyclomatic broadcasting algorithm");
+    void bind(Child* storage) {
+        first = storage;
+        count = 0;
     }
 
-    if ((int) g.edges.size() == g.n - 1) {
-        if (verbose) {
-            printHeader("Input graph is a tree");
-            printHeader("Using linear time tree-specific algorithm");
+    Child* begin() { return first; }
+    Child* end() { return first + count; }
+    const Child* begin() const { return first; }
+    const Child* end() const { return first + count; }
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    Child& operator[](int i) { return first[i]; }
+    const Child& operator[](int i) const { return first[i]; }
+    Child& back() { return first[count - 1]; }
+
+    void emplace_back(int u, int eid) { first[count++] = {u, eid}; }
+    void pop_back() { count -= 1; }
+    void clear() { count = 0; }
+
+private:
+    Child* first = nullptr;
+    int count = 0;
+};
+
+/**
+ * Scratch memory for the search on the spanning trees of G2. Every search thread
+ * owns one workspace, which is reused for all of its spanning trees and orderings,
+ * so that the search does not allocate memory in its inner loops.
+ *
+ *  - treeEdges are the directed edges of the current spanning tree T2, in the order
+ *    of SpanningTreeIterator::nextDirected, see setSpanningTree
+ *  - inT2[e2id] and usedXYTrees[id] mark the edges of G2 and the xyTrees in T2
+ *  - treeChildren[v] are the children of v in T2, in the order of treeEdges, and
+ *    parent[v] is the parent of v
+ *  - C[v] is the ordered list of children of v, see computeInitialC. The lists of all
+ *    vertices, their copies in bestOrder and treeChildren share one flat storage in
+ *    which every vertex has room for its degree in G2 in each of them.
+ *  - order lists the vertices of T2, every vertex after its parent, and positionInOrder
+ *    is its inverse
+ *  - r[v] is the time at which v is informed
+ *  - xyTreesStart[id] are the times at which x and y start informing an unused xyTree
+ *  - curRemoveEdges is the list of removed edges of the current solution
+ *  - isClosed[v] is true if every unused xyTree with one end in the subtree of v in T2
+ *    has its other end in the subtree as well. Then the subtree of v interacts with
+ *    the rest of T2 only through r[v], and it can be solved on its own.
+ *  - for closed v, groups[v] lists v and, in order, all descendants u of v that
+ *    are not closed and have no closed vertex between v and u. The orderings of the
+ *    members of one group are enumerated jointly.
+ *  - for closed v other than the source and the time limit boundsTarget[v], it is
+ *    known that the subtree of v can be informed in time if v is informed at time
+ *    knownFeasible[v] (-1 if no such time is known yet) and that it can not if v is
+ *    informed at time knownInfeasible[v]. bestOrder[u] stores the children order of
+ *    the members u of the group of v that achieves knownFeasible[v].
+ *  - subtreeBound[v] is a lower bound on the number of rounds that the subtree of v
+ *    in T2 needs after v is informed, see spanningTreeLowerBound. childNeed[e2id] is
+ *    the same bound for the child at the end of e2id, including the edge itself, and
+ *    0 for the unused xyTrees.
+ *  - leafChildren[v] is the number of leaf children of v in T2 with a deadline, see
+ *    computeLeafSendTimes, and leafChildrenNeed[v] the largest childNeed among them.
+ *    leafPositions and leafOrder are scratch space for them.
+ *  - childRank[e2id] is the position of the child at the end of e2id in ChildOrder,
+ *    and childKeys is scratch space to compute it.
+ */
+struct SearchWorkspace {
+    std::vector<int> treeEdges;
+    std::vector<char> inT2;
+    std::vector<char> usedXYTrees;
+    std::vector<ChildList> treeChildren;
+    std::vector<ChildList> C;
+    std::vector<int> order;
+    std::vector<int> positionInOrder;
+    std::vector<int> r;
+    std::vector<std::pair<int, int>> xyTreesStart;
+    std::vector<int> curRemoveEdges;
+    std::vector<int> parent;
+    std::vector<int> onPathStamp;
+    std::vector<char> isClosed;
+    std::vector<std::vector<int>> groups;
+    std::vector<int> knownFeasible;
+    std::vector<int> knownInfeasible;
+    std::vector<ChildList> bestOrder;
+    std::vector<int> boundsTarget;
+    std::vector<int> subtreeBound;
+    std::vector<int> childNeed;
+    std::vector<int> childBounds;
+    std::vector<int> leafChildren;
+    std::vector<int> leafChildrenNeed;
+    std::vector<int> leafPositions;
+    std::vector<int> childRank;
+    std::vector<std::pair<std::tuple<int, int, int, bool>, int>> childKeys;
+    std::vector<std::pair<int, std::pair<int, int>>> leafOrder;
+    int failedChild; // position in C[v] at which the last failed informChildren(v) stopped
+
+    // statistics of the search
+    long long numberOfOrderings = 0;
+    long long numberOfPrefixesVisited = 0;
+    long long numberOfPrefixesPruned = 0;
+    long long numberOfSubtreeSearches = 0;
+    long long numberOfSpanningTreesRejected = 0;
+
+    SearchWorkspace(const Kernel& kernel)
+        : inT2(kernel.G2.edges.size()), usedXYTrees(kernel.xyTrees.size()),
+          treeChildren(kernel.G2.n), C(kernel.G2.n), order{kernel.G2.s},
+          positionInOrder(kernel.G2.n), r(kernel.G2.n), xyTreesStart(kernel.xyTrees.size()),
+          parent(kernel.G2.n), onPathStamp(kernel.G2.n), isClosed(kernel.G2.n),
+          groups(kernel.G2.n), knownFeasible(kernel.G2.n), knownInfeasible(kernel.G2.n),
+          bestOrder(kernel.G2.n), boundsTarget(kernel.G2.n), subtreeBound(kernel.G2.n),
+          childNeed(kernel.G2.edges.size()), leafChildren(kernel.G2.n), leafChildrenNeed(kernel.G2.n),
+          childRank(kernel.G2.edges.size()), childStorage(6 * kernel.G2.edges.size()) {
+        std::vector<int> degree(kernel.G2.n, 0);
+        for (auto [u, v] : kernel.G2.edges) {
+            degree[u] += 1;
+            degree[v] += 1;
         }
-        BroadcastingProtocol ans = solveOnTree(g);
-        if (verbose) {
-            double totalTime = totalTimer.elapsed();
-            printInfo("Optimal broadcasting rounds", static_cast<unsigned long long>(ans.rounds.size()));
-            printEmptyLine();
-            printInfo("Total algorithm time", totalTime);
+        int offset = 0;
+        for (int v = 0; v < kernel.G2.n; ++v) {
+            C[v].bind(childStorage.data() + offset);
+            bestOrder[v].bind(childStorage.data() + offset + degree[v]);
+            treeChildren[v].bind(childStorage.data() + offset + 2 * degree[v]);
+            offset += 3 * degree[v];
         }
-        return ans;
+        // T2 starts without edges
+        parent[kernel.G2.s] = -1;
+        positionInOrder[kernel.G2.s] = 0;
     }
 
-    // === Preprocessing Step ===
-    Timer preprocessTimer;
+    // C, bestOrder and treeChildren point into childStorage
+    SearchWorkspace(const SearchWorkspace&) = delete;
+    SearchWorkspace& operator=(const SearchWorkspace&) = delete;
 
-    std::vector<std::vector<std::pair<int, int>>> adj(g.n);
-    for (int i = 0; i < (int) g.edges.size(); ++i) {
-        const auto& [u, v] = g.edges[i];
-        adj[u].emplace_back(v, i);
-        adj[v].emplace_back(u, i);
-    }
+private:
+    std::vector<std::pair<int, int>> childStorage;
+};
 
-    std::vector<int> S = getMinimalFeedbackEdgeSet(g, adj);
-    std::vector<int> U = constructU(g, adj, S);
+// the send time of computeLeafSendTimes if the child (u, eid) of v is a leaf of T2
+// with a deadline, and -1 otherwise
+int leafSendTime(const Kernel& kernel, const SearchWorkspace& ws, int v, const std::pair<int, int>& child) {
+    auto [u, eid] = child;
+    if (!ws.inT2[eid] || !ws.C[u].empty()) return -1;
+    return kernel.leafSendTime[2 * eid + (kernel.G2.edges[eid].first == v ? 0 : 1)];
+}
 
-    std::vector<int> positionInU(g.n, -1);
-    for (int i = 0; i < (int) U.size(); ++i) {
-        positionInU[U[i]] = i;
+// The order of the children lists C[v] in which their orderings are enumerated.
+// Children that need more time come first, like in solveOnTree, so the first orderings
+// that are tried are the most promising ones. If v has several leaf children with a
+// deadline, they all compare equal, with the largest need among them, so that only
+// the positions they take are enumerated, and arrangeLeafChildren puts them into these
+// positions by their deadlines. Interchangeable children of v in T2 without children
+// of their own compare equal, so that only orderings that differ in more than swapping
+// them are enumerated. Otherwise ties are broken by (u, eid), and by eid alone for the
+// unused xyTrees, which are children of both of their ends.
+std::tuple<int, int, int, bool> childKey(const Kernel& kernel,
+        const SearchWorkspace& ws,
+        int v,
+        const std::pair<int, int>& child) {
+    auto [u, eid] = child;
+    if (!ws.inT2[eid]) return {0, -1, eid, true};
+    if (ws.leafChildren[v] > 1 && leafSendTime(kernel, ws, v, child) != -1) {
+        return {-ws.leafChildrenNeed[v], std::numeric_limits<int>::min(), 0, false};
     }
+    if (kernel.hasInterchangeableChildren && ws.C[u].empty()) {
+        int a = 2 * eid + (kernel.G2.edges[eid].first == v ? 0 : 1);
+        int b = kernel.childClass[a];
+        auto [x, y] = kernel.G2.edges[b / 2];
+        return {-ws.childNeed[eid], b % 2 == 0 ? y : x, b / 2, false};
+    }
+    return {-ws.childNeed[eid], u, eid, true};
+}
 
-    std::vector<int> timeNeededForXTrees;
-    std::vector<std::vector<int>> freeChildrenPositions;
-
-    std::vector<XYTree> xyTrees;
-    std::vector<std::vector<std::vector<int>>> bh;
-    std::vector<std::vector<std::vector<int>>> dh;
-    std::vector<std::vector<std::vector<int>>> dhRemoveEdge;
-    preProcessXTreesAndXYTrees(g, adj, U, positionInU, timeNeededForXTrees,
-        freeChildrenPositions, xyTrees, bh, dh, dhRemoveEdge);
+// compares children by childKey, which sortAllChildren turns into a rank for every
+// edge of G2 once per spanning tree. Every edge is in the list of one vertex, or of
+// both ends for an unused xyTree, whose key is the same at both ends.
+struct ChildOrder {
+    const std::vector<int>& rank;
 
-    std::vector<int> bestRemoveEdges = S;
-    int bestBroadcastingTime = solveOnTree(g, S).rounds.size();
+    explicit ChildOrder(const SearchWorkspace& ws) : rank(ws.childRank) {}
 
-    Graph G2;
-    std::vector<int> correspondingEdgeInG;
-    constructG2(g, U, positionInU, xyTrees, G2, correspondingEdgeInG);
+    bool operator()(const std::pair<int, int>& a, const std::pair<int, int>& b) const {
+        return rank[a.second] < rank[b.second];
+    }
+};
+
+// puts the leaf children of v with a deadline into the positions in C[v] that they
+// take, the one that has to be sent to first (the largest send time) first
+void arrangeLeafChildren(const Kernel& kernel, SearchWorkspace& ws, int v) {
+    ChildList& children = ws.C[v];
+    ws.leafPositions.clear();
+    ws.leafOrder.clear();
+    for (int i = 0; i < children.size(); ++i) {
+        int sendTime = leafSendTime(kernel, ws, v, children[i]);
+        if (sendTime == -1) continue;
+        ws.leafPositions.push_back(i);
+        ws.leafOrder.emplace_back(-sendTime, children[i]);
+    }
+    std::sort(ws.leafOrder.begin(), ws.leafOrder.end());
+    for (int i = 0; i < (int) ws.leafPositions.size(); ++i) {
+        children[ws.leafPositions[i]] = ws.leafOrder[i].second;
+    }
+}
+
+void sortChildren(const Kernel& kernel, SearchWorkspace& ws, int v) {
+    std::sort(ws.C[v].begin(), ws.C[v].end(), ChildOrder(ws));
+    if (ws.leafChildren[v] > 1) arrangeLeafChildren(kernel, ws, v);
+}
+
+bool nextChildOrdering(const Kernel& kernel, SearchWorkspace& ws, int v) {
+    bool hasNext = std::next_permutation(ws.C[v].begin(), ws.C[v].end(), ChildOrder(ws));
+    if (ws.leafChildren[v] > 1) arrangeLeafChildren(kernel, ws, v);
+    return hasNext;
+}
+
+// sorts all lists C[v] by ChildOrder, after it counted the leaf children with a deadline
+// and ranked the children by childKey
+void sortAllChildren(const Kernel& kernel, SearchWorkspace& ws) {
+    for (int v = 0; v < kernel.G2.n; ++v) {
+        ws.leafChildren[v] = 0;
+        ws.leafChildrenNeed[v] = 0;
+        for (const auto& child : ws.C[v]) {
+            if (leafSendTime(kernel, ws, v, child) == -1) continue;
+            ws.leafChildren[v] += 1;
+            ws.leafChildrenNeed[v] = std::max(ws.leafChildrenNeed[v], ws.childNeed[child.second]);
+        }
+    }
+
+    ws.childKeys.clear();
+    for (int v = 0; v < kernel.G2.n; ++v) {
+        for (const auto& child : ws.C[v]) {
+            ws.childKeys.emplace_back(childKey(kernel, ws, v, child), child.second);
+        }
+    }
+    std::sort(ws.childKeys.begin(), ws.childKeys.end());
+    int rank = 0;
+    for (int i = 0; i < (int) ws.childKeys.size(); ++i) {
+        if (i > 0 && ws.childKeys[i].first != ws.childKeys[i - 1].first) rank += 1;
+        ws.childRank[ws.childKeys[i].second] = rank;
+    }
+
+    for (int v = 0; v < kernel.G2.n; ++v) {
+        sortChildren(kernel, ws, v);
+    }
+}
+
+// makes the children of v after the given position the last of their orderings, so
+// that the next ordering of C[v] differs in one of the children up to that position.
+// With position -1 there is no next ordering.
+void skipChildOrderings(const Kernel& kernel, SearchWorkspace& ws, int v, int position) {
+    auto rest = ws.C[v].begin() + position + 1;
+    if (ws.C[v].end() - rest < 2) return;
+    std::sort(rest, ws.C[v].end(), ChildOrder(ws));
+    std::reverse(rest, ws.C[v].end());
+    if (ws.leafChildren[v] > 1) arrangeLeafChildren(kernel, ws, v);
+}
+
+// It makes T2, given by its directed edges in the order of
+// SpanningTreeIterator::nextDirected, the spanning tree of the workspace. The edges
+// at the start of the list that T2 shares with the previous tree are kept, and only
+// the rest of the previous tree is removed and the rest of T2 is added. The edges
+// are removed last to first, so every removed child is the last one of its parent.
+void setSpanningTree(const Kernel& kernel,
+        const std::vector<int>& T2,
+        SearchWorkspace& ws) {
+    const Graph& G2 = kernel.G2;
+
+    int shared = 0;
+    while (shared < (int) std::min(T2.size(), ws.treeEdges.size()) && T2[shared] == ws.treeEdges[shared]) {
+        shared += 1;
+    }
+    while ((int) ws.treeEdges.size() > shared) {
+        int a = ws.treeEdges.back();
+        ws.treeEdges.pop_back();
+        int e2id = a / 2;
+        ws.inT2[e2id] = false;
+        if (e2id >= kernel.firstXYTreeEdge) {
+            ws.usedXYTrees[e2id - kernel.firstXYTreeEdge] = false;
+        }
+        auto [x, y] = G2.edges[e2id];
+        ws.treeChildren[a % 2 == 0 ? x : y].pop_back();
+        ws.order.pop_back();
+    }
+    for (int i = shared; i < (int) T2.size(); ++i) {
+        int a = T2[i];
+        ws.treeEdges.push_back(a);
+        int e2id = a / 2;
+        ws.inT2[e2id] = true;
+        if (e2id >= kernel.firstXYTreeEdge) {
+            ws.usedXYTrees[e2id - kernel.firstXYTreeEdge] = true;
+        }
+        auto [x, y] = G2.edges[e2id];
+        int v = a % 2 == 0 ? x : y;
+        int u = a % 2 == 0 ? y : x;
+        ws.treeChildren[v].emplace_back(u, e2id);
+        ws.parent[u] = v;
+        ws.positionInOrder[u] = (int) ws.order.size();
+        ws.order.push_back(u);
+    }
+    assert((int) ws.order.size() == G2.n);
+}
+
+// for the spanning tree T2 of setSpanningTree it computes the children C[v] of every
+// vertex v, when T2 is rooted at the source. The unused xyTrees are children of both
+// of their ends. The lists are sorted by ChildOrder only by sortAllChildren, after the
+// needs of the children are computed by spanningTreeLowerBound. It also computes the
+// closed vertices and their groups. It is only needed for the trees that are not
+// rejected by spanningTreeLowerBound.
+void computeInitialC(const Kernel& kernel, SearchWorkspace& ws) {
+    const Graph& G2 = kernel.G2;
+    const std::vector<XYTree>& xyTrees = kernel.xyTrees;
+
+    for (int v = 0; v < G2.n; ++v) {
+        ws.C[v].clear();
+        for (auto [u, eid] : ws.treeChildren[v]) ws.C[v].emplace_back(u, eid);
+    }
+
+    // a vertex is not closed if it lies on the path from an end of an unused
+    // xyTree to the lowest common ancestor of both ends (excluding the ancestor)
+    std::fill(ws.isClosed.begin(), ws.isClosed.end(), true);
+    std::fill(ws.onPathStamp.begin(), ws.onPathStamp.end(), -1);
+
+    for (int i = 0; i < (int) xyTrees.size(); ++i) {
+        if (ws.usedXYTrees[i]) continue;
+        auto [x, y] = G2.edges[kernel.firstXYTreeEdge + i];
+        ws.C[x].emplace_back(y, kernel.firstXYTreeEdge + i);
+        ws.C[y].emplace_back(x, kernel.firstXYTreeEdge + i);
+        ws.childNeed[kernel.firstXYTreeEdge + i] = 0;
+
+        for (int v = x; v != -1; v = ws.parent[v]) ws.onPathStamp[v] = i;
+        int lca = y;
+        while (ws.onPathStamp[lca] != i) {
+            ws.isClosed[lca] = false;
+            lca = ws.parent[lca];
+        }
+        for (int v = x; v != lca; v = ws.parent[v]) ws.isClosed[v] = false;
+    }
+
+    for (int v = 0; v < G2.n; ++v) {
+        ws.groups[v].clear();
+    }
+
+    // the group of a vertex that is not closed is the group of its parent
+    for (int v : ws.order) {
+        int root = v;
+        while (!ws.isClosed[root]) root = ws.parent[root];
+        ws.groups[root].push_back(v);
+    }
+    std::fill(ws.boundsTarget.begin(), ws.boundsTarget.end(), -1);
+}
+
+// the times, relative to the time at which v is informed, at which v informs its
+// children in C[v] one after another, when v has haveExtra more time than it needs for
+// its xTrees. The first children are informed before the xTrees, then the free
+// positions between the xTrees are used, and the remaining children come last.
+struct SendTimes {
+    const std::vector<int>& freePositions;
+    int haveExtra;
+    int usedExtra = 0;
+    int fcPos = 0;
+    int addCounter = 1;
+
+    SendTimes(const std::vector<int>& _freePositions, int _haveExtra)
+        : freePositions(_freePositions), haveExtra(_haveExtra) {}
+
+    int next() {
+        if (usedExtra < haveExtra) {
+            return usedExtra++;
+        }
+        if (fcPos < (int) freePositions.size()) {
+            return haveExtra + freePositions[fcPos++];
+        }
+        return haveExtra + freePositions.back() + addCounter++;
+    }
+};
+
+bool canInformSubtree(const Kernel& kernel, SearchWorkspace& ws, int v, int arrival, int t);
+
+// for a vertex v of a spanning tree T2 whose arrival time r[v] is already known, it
+// lets v inform its children in their current order within the time limit t. It sets
+// the arrival times r[u] of the children u of v in T2 and the start times of the unused
+// xyTrees incident to v. If the other end of an unused xyTree appears before v in
+// ws.order, the xyTree is checked as well. The subtrees of closed children are
+// checked on their own.
+// It returns false if this already shows that the time limit t can not be met, no
+// matter how the children of the vertices after v in ws.order are ordered. Then
+// ws.failedChild is the position of the child that showed it, or -1 if v itself is
+// informed too late. Only the children up to that position were needed to show it.
+bool informChildren(const Kernel& kernel,
+        SearchWorkspace& ws,
+        int v,
+        int t) {
+    const std::vector<XYTree>& xyTrees = kernel.xyTrees;
+    const std::vector<int>& timeNeededForXTrees = kernel.timeNeededForXTrees;
+    const PiecewiseTables& bh = kernel.bh;
+    const PiecewiseTables& dh = kernel.dh;
+    std::vector<int>& r = ws.r;
+
+    ws.failedChild = -1;
+    if (r[v] > t) return false;
+    int timeLeft = t - r[v];
+    if (timeLeft < timeNeededForXTrees[v]) return false;
+    int position = -1;
+    auto fail = [&]() {
+        ws.failedChild = position;
+        return false;
+    };
+    SendTimes sendTimes(kernel.freeChildrenPositions[v], timeLeft - timeNeededForXTrees[v]);
+    for (auto [u, eid] : ws.C[v]) {
+        position += 1;
+        int addTime = sendTimes.next();
+        int arrival;
+        if (eid >= kernel.firstXYTreeEdge) {
+            int id = eid - kernel.firstXYTreeEdge;
+            int j = kernel.U[v] == xyTrees[id].x ? 0 : 1;
+            // an unused xyTree may start after t, then it is informed from its other end
+            if (!ws.usedXYTrees[id]) {
+                int t1 = -1;
+                int t2 = -1;
+                bool otherEndDone = ws.positionInOrder[u] < ws.positionInOrder[v];
+                if (j == 0) {
+                    ws.xyTreesStart[id].first = t1 = r[v] + addTime;
+                    if (otherEndDone) t2 = ws.xyTreesStart[id].second;
+                }
+                else {
+                    ws.xyTreesStart[id].second = t2 = r[v] + addTime;
+                    if (otherEndDone) t1 = ws.xyTreesStart[id].first;
+                }
+                if (t1 != -1 && t2 != -1) {
+                    if (t1 <= t2) {
+                        if (t1 + dh.value(2 * id, t2 - t1) > t) return fail();
+                    }
+                    else {
+                        if (t2 + dh.value(2 * id + 1, t1 - t2) > t) return fail();
+                    }
+                }
+                continue;
+            }
+            if (r[v] + addTime > t) return fail();
+            arrival = r[v] + addTime + bh.value(2 * id + j, t - (r[v] + addTime));
+        }
+        else {
+            arrival = r[v] + addTime + 1;
+        }
+        if (arrival > t - timeNeededForXTrees[u]) return fail();
+        // checking the subtree of u overwrites r[u], so r[u] is set afterwards
+        if (ws.isClosed[u] && !canInformSubtree(kernel, ws, u, arrival, t)) return fail();
+        r[u] = arrival;
+    }
+    return true;
+}
+
+// checks if all members of the group of the closed vertex v can inform their children
+// in their current order within the time limit t, when v is informed at time arrival
+bool evaluateGroup(const Kernel& kernel,
+        SearchWorkspace& ws,
+        int v,
+        int arrival,
+        int t) {
+    ws.r[v] = arrival;
+    for (int u : ws.groups[v]) {
+        if (!informChildren(kernel, ws, u, t)) return false;
+    }
+    return true;
+}
+
+// Enumerates all combinations of orderings of the children lists of the members of
+// the group of the closed vertex v, member by member in ws.order, starting at the
+// i-th member. Every prefix is checked with informChildren against the time limit
+// limit(), so that all combinations that extend an infeasible prefix are skipped at
+// once. onOrdering() is called for every combination whose prefixes all passed, and
+// the enumeration stops as soon as it returns true. It returns true in that case.
+// The earlier members keep their arrival times, so a new ordering of a member only
+// informs the members after it again. The orderings of a member are visited in
+// lexicographic order, and when one of its children can not be informed in time, all
+// orderings that agree with it up to that child are skipped at once.
+template <typename Limit, typename OnOrdering>
+bool enumerateGroupOrderings(const Kernel& kernel,
+        SearchWorkspace& ws,
+        int v,
+        int i,
+        const Limit& limit,
+        const OnOrdering& onOrdering) {
+    const std::vector<int>& members = ws.groups[v];
+    if (i == (int) members.size()) {
+        return onOrdering();
+    }
+    int u = members[i];
+    do {
+        if (informChildren(kernel, ws, u, limit())) {
+            ws.numberOfPrefixesVisited += 1;
+            if (enumerateGroupOrderings(kernel, ws, v, i + 1, limit, onOrdering)) return true;
+        }
+        else {
+            ws.numberOfPrefixesPruned += 1;
+            skipChildOrderings(kernel, ws, u, ws.failedChild);
+        }
+    }
+    while (nextChildOrdering(kernel, ws, u));
+    return false;
+}
+
+// checks if the subtree of the closed vertex v can be informed within the time limit
+// t when v is informed at time arrival. The subtree of a closed vertex depends on the
+// rest of T2 only through this time, so the orderings of its group are enumerated on
+// their own instead of as part of the product over all vertices, and the answers
+// are remembered for all further arrival times and orderings of the rest of T2.
+// If it returns true, the members of the group are left in an order that works.
+bool canInformSubtree(const Kernel& kernel,
+        SearchWorkspace& ws,
+        int v,
+        int arrival,
+        int t) {
+    if (ws.boundsTarget[v] != t) {
+        ws.boundsTarget[v] = t;
+        ws.knownFeasible[v] = -1;
+        ws.knownInfeasible[v] = t - kernel.timeNeededForXTrees[v] + 1;
+    }
+    // being feasible is monotone in the arrival time
+    if (arrival <= ws.knownFeasible[v]) return true;
+    if (arrival >= ws.knownInfeasible[v]) return false;
+    ws.numberOfSubtreeSearches += 1;
+
+    const std::vector<int>& members = ws.groups[v];
+    for (int u : members) {
+        sortChildren(kernel, ws, u);
+    }
+
+    ws.r[v] = arrival;
+    bool found = enumerateGroupOrderings(kernel, ws, v, 0, [&]() { return t; }, [&]() {
+        // find the latest arrival time for which this combination works
+        int lo = arrival;
+        int hi = ws.knownInfeasible[v] - 1;
+        while (lo < hi) {
+            int mid = lo + (hi - lo + 1) / 2;
+            if (evaluateGroup(kernel, ws, v, mid, t)) lo = mid;
+            else hi = mid - 1;
+        }
+        ws.knownFeasible[v] = lo;
+        return true;
+    });
+
+    if (found) {
+        for (int u : members) {
+            ws.bestOrder[u].clear();
+            for (auto [w, eid] : ws.C[u]) ws.bestOrder[u].emplace_back(w, eid);
+        }
+        return true;
+    }
+    ws.knownInfeasible[v] = arrival;
+    if (ws.knownFeasible[v] != -1) {
+        for (int u : members) {
+            std::copy(ws.bestOrder[u].begin(), ws.bestOrder[u].end(), ws.C[u].begin());
+        }
+    }
+    return false;
+}
+
+// for a given spanning tree T2 and ordered list of children for every vertex
+// and a given time limit t, it checks if the T2 with the given children orders
+// can be expanded to a valid broadcasting protocol on the whole graph.
+// It visits the vertices in ws.order, so every vertex is informed
+// before it informs its own children. The closed vertices are informed in the
+// order of their groups that was found for the time limit t.
+bool isFeasible(const Kernel& kernel,
+        SearchWorkspace& ws,
+        int t) {
+    ws.r[kernel.G2.s] = 0;
+    for (int v : ws.order) {
+        if (!informChildren(kernel, ws, v, t)) return false;
+    }
+    return true;
+}
+
+// for a given spanning tree T2 and ordered children lists that are feasible for the
+// time limit t, it finds the smallest time limit of at least lowerBound for which they
+// are feasible. Being feasible is monotone in the time limit, so it binary searches
+// instead of lowering the time limit one by one. Afterwards ws holds the state of
+// isFeasible for the returned time limit. It returns -1 if they are not feasible for t.
+int minimalFeasibleTime(const Kernel& kernel,
+        SearchWorkspace& ws,
+        int lowerBound,
+        int t) {
+    if (!isFeasible(kernel, ws, t)) return -1;
+    int lo = lowerBound;
+    int hi = t;
+    bool stateIsForHi = true;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        stateIsForHi = isFeasible(kernel, ws, mid);
+        if (stateIsForHi) hi = mid;
+        else lo = mid + 1;
+    }
+    if (!stateIsForHi) isFeasible(kernel, ws, hi);
+    return hi;
+}
+
+// for the spanning tree T2 of setSpanningTree, it computes a lower
+// bound on the time limit for which T2 can be feasible, for any ordering of the children
+// lists. Bottom up in T2, v needs subtreeBound[v] rounds after it is informed: its
+// children in T2 are sent in the order of their own needs, each over its edge, which
+// takes at least one round or the smallest value of bh for an xyTree, and the sends
+// are placed around the xTrees of v by SendTimes. The unused xyTrees are ignored, so
+// it never exceeds the time that isFeasible needs. The needs of the children are kept
+// in childNeed for childKey. It only needs the tree edges, so it is cheap enough to
+// reject most trees before computeInitialC.
+int spanningTreeLowerBound(const Kernel& kernel, SearchWorkspace& ws) {
+    for (int i = kernel.G2.n - 1; i >= 0; --i) {
+        int v = ws.order[i];
+        ws.childBounds.clear();
+        for (auto [u, eid] : ws.treeChildren[v]) {
+            int edgeTime = 1;
+            if (eid >= kernel.firstXYTreeEdge) {
+                int id = eid - kernel.firstXYTreeEdge;
+                edgeTime = kernel.bh.minimum(2 * id + (kernel.U[v] == kernel.xyTrees[id].x ? 0 : 1));
+            }
+            ws.childNeed[eid] = edgeTime + ws.subtreeBound[u];
+            ws.childBounds.push_back(ws.childNeed[eid]);
+        }
+        std::sort(ws.childBounds.begin(), ws.childBounds.end(), std::greater<int>());
+
+        int bound = kernel.timeNeededForXTrees[v];
+        for (int k = 0; k < (int) ws.childBounds.size(); ++k) {
+            bound = std::max(bound, k + ws.childBounds[k]);
+        }
+        // more time leaves more children before the xTrees, so the smallest bound
+        // for which all children fit is found by counting up
+        while (true) {
+            SendTimes sendTimes(kernel.freeChildrenPositions[v], bound - kernel.timeNeededForXTrees[v]);
+            bool fits = true;
+            for (int childBound : ws.childBounds) {
+                if (sendTimes.next() + childBound > bound) {
+                    fits = false;
+                    break;
+                }
+            }
+            if (fits) break;
+            bound += 1;
+        }
+        ws.subtreeBound[v] = bound;
+    }
+    return ws.subtreeBound[kernel.G2.s];
+}
+
+// after a successful call of isFeasible with time limit t, it collects the edges
+// that are removed from g in the corresponding solution in ws.curRemoveEdges:
+// all edges between vertices in U that are not in T2 and one edge on the path of
+// every unused xyTree
+void collectRemoveEdges(const Kernel& kernel,
+        SearchWorkspace& ws,
+        [[maybe_unused]] int t) {
+    const PiecewiseTables& dh = kernel.dh;
+
+    ws.curRemoveEdges.clear();
+    for (int i = 0; i < (int) kernel.xyTrees.size(); ++i) {
+        if (!ws.usedXYTrees[i]) {
+            auto [t1, t2] = ws.xyTreesStart[i];
+            assert(t1 != -1 && t2 != -1);
+            if (t1 <= t2) {
+                assert(t1 + dh.value(2 * i, t2 - t1) <= t);
+                ws.curRemoveEdges.push_back(dh.edge(2 * i, t2 - t1));
+            }
+            else {
+                assert(t2 + dh.value(2 * i + 1, t1 - t2) <= t);
+                ws.curRemoveEdges.push_back(dh.edge(2 * i + 1, t1 - t2));
+            }
+        }
+    }
+    for (int i = 0; i < kernel.firstXYTreeEdge; ++i) {
+        if (!ws.inT2[i]) ws.curRemoveEdges.push_back(kernel.correspondingEdgeInG[i]);
+    }
+}
+
+// for the connected graph g it returns the edges that are not in a shortest path tree
+// rooted at root. The parent of every vertex is chosen uniformly at random among its
+// neighbours that are closer to the root, if rng is given, and otherwise it is the
+// first such neighbour in the adjacency list.
+std::vector<int> getShortestPathTreeComplement(const Graph& g,
+        const Adjacency& adj,
+        int root,
+        std::mt19937* rng) {
+    std::vector<int> dist(g.n, -1);
+    std::queue<int> q;
+    dist[root] = 0;
+    q.push(root);
+    while (!q.empty()) {
+        int v = q.front();
+        q.pop();
+        for (auto [u, eid] : adj[v]) {
+            if (dist[u] == -1) {
+                dist[u] = dist[v] + 1;
+                q.push(u);
+            }
+        }
+    }
+
+    std::vector<bool> isEdgeInTree(g.edges.size(), false);
+    for (int v = 0; v < g.n; ++v) {
+        if (v == root) continue;
+        int parentEdge = -1;
+        int numberOfCandidates = 0;
+        for (auto [u, eid] : adj[v]) {
+            if (dist[u] != dist[v] - 1) continue;
+            numberOfCandidates += 1;
+            if (parentEdge == -1) {
+                parentEdge = eid;
+            }
+            else if (rng != nullptr && (*rng)() % numberOfCandidates == 0) {
+                parentEdge = eid;
+            }
+        }
+        isEdgeInTree[parentEdge] = true;
+    }
+
+    std::vector<int> removeEdges;
+    for (int i = 0; i < (int) g.edges.size(); ++i) {
+        if (!isEdgeInTree[i]) removeEdges.push_back(i);
+    }
+    return removeEdges;
+}
+
+/**
+ * Computes an optimal broadcasting protocol for the spanning tree of g without the
+ * edges removeEdges, like solveOnTree, but it only peels the kernel tree K. The removed
+ * edges lie on cycles of g, so they are edges of K, and the subtrees of all peeled
+ * vertices are the same in every spanning tree, so their times and children are taken
+ * from the preprocessing. A vertex of K informs its peeled children and its children
+ * in K merged by decreasing time needed, which gives the same protocol as solveOnTree.
+ *
+ * Time Complexity: O(n) for the protocol, plus O(|K| log |K|) for the peeling of K.
+ */
+BroadcastingProtocol solveOnKernelTree(const Kernel& kernel, const std::vector<int>& removeEdges) {
+    const Graph& K = kernel.K;
+    const std::vector<int>& peeledDP = kernel.peeledDP;
+    const PeeledChildren& peeledChildren = kernel.peeledChildren;
+
+    std::vector<int> removed = removeEdges;
+    std::sort(removed.begin(), removed.end());
+    removed.erase(std::unique(removed.begin(), removed.end()), removed.end());
+
+    std::vector<bool> edgeOk(K.edges.size(), true);
+    std::vector<int> deg(K.n, 0);
+    int numberOfRemovedEdges = 0;
+    for (int i = 0; i < (int) K.edges.size(); ++i) {
+        if (std::binary_search(removed.begin(), removed.end(), kernel.edgeInG[i])) {
+            edgeOk[i] = false;
+            numberOfRemovedEdges += 1;
+            continue;
+        }
+        auto [u, v] = K.edges[i];
+        deg[u] += 1;
+        deg[v] += 1;
+    }
+
+    // all other edges are bridges of g
+    if (numberOfRemovedEdges != (int) removed.size()) {
+        throw std::runtime_error("The given graph is not connected.");
+    }
+
+    // dp[v] = time needed to inform the subtree of the vertex v of K
+    std::vector<int> dp(K.n, -1);
+
+    // the children of v in K are stored in childBuffer from childBegin[v] to
+    // childEnd[v], in one slot per edge of v
+    std::vector<int> childEnd(K.n);
+    for (int v = 0, end = 0; v < K.n; ++v) {
+        end += deg[v];
+        childEnd[v] = end;
+    }
+    std::vector<int> childBegin = childEnd;
+    std::vector<int> childBuffer(childEnd.empty() ? 0 : childEnd.back());
+
+    // calls f(w, u, position) for the children w of the vertex v of K in the order in
+    // which v informs them, by decreasing dp and then by vertex like solveOnTree, where
+    // u is the vertex of K of w, or -1 if w is peeled. The children of v in K must be
+    // sorted in this order
+    auto before = [&](int needA, int a, int needB, int b) {
+        return needA != needB ? needA > needB : a < b;
+    };
+    auto forEachChild = [&](int v, auto&& f) {
+        PeeledChildren::Range peeled = peeledChildren[kernel.vertexInG[v]];
+        int i = 0;
+        int j = childBegin[v];
+        while (i < peeled.size() || j < childEnd[v]) {
+            int position = i + j - childBegin[v];
+            if (j == childEnd[v] || (i < peeled.size() && before(peeledDP[peeled[i]], peeled[i],
+                    dp[childBuffer[j]], kernel.vertexInG[childBuffer[j]]))) {
+                f(peeled[i], -1, position);
+                i += 1;
+            }
+            else {
+                f(kernel.vertexInG[childBuffer[j]], childBuffer[j], position);
+                j += 1;
+            }
+        }
+    };
+
+    auto computeDP = [&](int v) {
+        std::sort(childBuffer.begin() + childBegin[v], childBuffer.begin() + childEnd[v], [&](int a, int b) {
+            return before(dp[a], kernel.vertexInG[a], dp[b], kernel.vertexInG[b]);
+        });
+        dp[v] = 0;
+        forEachChild(v, [&](int w, int u, int position) {
+            dp[v] = std::max(dp[v], (u == -1 ? peeledDP[w] : dp[u]) + 1 + position);
+        });
+    };
+
+    // the leaves are peeled in any order, since the children of a vertex are sorted
+    // when it becomes a leaf
+    std::vector<int> leaves;
+    for (int v = 0; v < K.n; ++v) {
+        if (deg[v] == 1 && v != K.s) {
+            computeDP(v);
+            leaves.push_back(v);
+        }
+    }
+    while (!leaves.empty()) {
+        int v = leaves.back();
+        leaves.pop_back();
+        if (deg[v] != 1) {
+            throw std::runtime_error("The given graph is not connected.");
+        }
+        for (auto [u, eid] : kernel.adjK[v]) {
+            if (!edgeOk[eid] || deg[u] == 0) continue;
+            childBegin[u] -= 1;
+            childBuffer[childBegin[u]] = v;
+            deg[u] -= 1;
+            deg[v] -= 1;
+            if (deg[u] == 1 && u != K.s) {
+                computeDP(u);
+                leaves.push_back(u);
+            }
+        }
+    }
+
+    for (int v = 0; v < K.n; ++v) {
+        if (deg[v] >= 1) {
+            throw std::runtime_error("The given graph contains cycles.");
+        }
+        if (dp[v] == -1 && v != K.s) {
+            throw std::runtime_error("The given graph is not connected.");
+        }
+    }
+    computeDP(K.s);
+
+    BroadcastingProtocol ans;
+    ans.rounds.resize(dp[K.s]);
+
+    // stack of informed vertices w of g, with their vertex u of K or -1, and the time
+    // at which they are informed
+    std::vector<std::tuple<int, int, int>> st;
+    st.emplace_back(kernel.vertexInG[K.s], K.s, 0);
+    while (!st.empty()) {
+        auto [v, inK, t] = st.back();
+        st.pop_back();
+        int from = v;
+        int time = t;
+        auto inform = [&](int w, int u, int position) {
+            ans.rounds[time + position].emplace_back(from, w);
+            st.emplace_back(w, u, time + 1 + position);
+        };
+        if (inK != -1) {
+            forEachChild(inK, inform);
+        }
+        else {
+            PeeledChildren::Range peeled = peeledChildren[v];
+            for (int i = 0; i < peeled.size(); ++i) inform(peeled[i], -1, i);
+        }
+    }
+
+    return ans;
+}
+
+// a spanning tree of g, given by its removed edges, together with its optimal protocol.
+// Trees are compared by their broadcasting time first and then by the number of
+// vertices informed in the last round, which lets the edge swaps make progress on
+// plateaus of equal broadcasting time.
+struct CandidateTree {
+    std::vector<int> removeEdges;
+    BroadcastingProtocol protocol;
+
+    CandidateTree(const Kernel& kernel, const std::vector<int>& _removeEdges)
+        : removeEdges(_removeEdges), protocol(solveOnKernelTree(kernel, _removeEdges)) {}
+
+    std::pair<int, int> score() const {
+        int lastRound = protocol.rounds.empty() ? 0 : (int) protocol.rounds.back().size();
+        return {(int) protocol.rounds.size(), lastRound};
+    }
+};
+
+// number of spanning trees with random shortest path trees that are evaluated for the
+// initial solution, and an upper bound on the number of trees evaluated for edge swaps
+const int RANDOM_INITIAL_TREES = 4;
+const int MAX_EDGE_SWAP_TREES = 32;
+const unsigned INITIAL_TREES_SEED = 20240607;
+
+// It computes a good initial solution for the search, so that the search starts with
+// a tight bound. It evaluates the spanning tree given by S, a shortest path tree from
+// the source, and some random shortest path trees, and then improves the best of them
+// greedily: a removed edge {a, b} is added back, and the edge to the parent of the vertex
+// informed last on the cycle it closes is removed instead, on each side of the cycle.
+// Only swaps that cut off a vertex informed in the last round can improve the score,
+// so only those are evaluated. A swap is kept if the resulting tree is better.
+// It returns the removed edges of the best spanning tree found.
+std::vector<int> findInitialSolution(const Graph& g,
+        const Adjacency& adj,
+        const Kernel& kernel,
+        const std::vector<int>& S,
+        int lowerBound,
+        int& numberOfTreesEvaluated) {
+    std::mt19937 rng(INITIAL_TREES_SEED);
+
+    CandidateTree best(kernel, S);
+    numberOfTreesEvaluated = 1;
+    auto consider = [&](const std::vector<int>& removeEdges) {
+        CandidateTree candidate(kernel, removeEdges);
+        numberOfTreesEvaluated += 1;
+        if (candidate.score() < best.score()) {
+            best = std::move(candidate);
+            return true;
+        }
+        return false;
+    };
+
+    consider(getShortestPathTreeComplement(g, adj, g.s, nullptr));
+    for (int i = 0; i < RANDOM_INITIAL_TREES; ++i) {
+        consider(getShortestPathTreeComplement(g, adj, g.s, &rng));
+    }
+
+    std::vector<int> informedAt(g.n);
+    std::vector<int> parentEdge(g.n);
+    std::vector<int> onPathStamp(g.n, -1);
+    int stamp = 0;
+
+    bool improved = true;
+    while (improved && (int) best.protocol.rounds.size() > lowerBound) {
+        improved = false;
+
+        // the tree of the best protocol, rooted at the source
+        informedAt[g.s] = 0;
+        parentEdge[g.s] = -1;
+        for (int i = 0; i < (int) best.protocol.rounds.size(); ++i) {
+            for (auto [u, v] : best.protocol.rounds[i]) {
+                informedAt[v] = i + 1;
+                for (auto [w, eid] : adj[v]) {
+                    if (w == u) parentEdge[v] = eid;
+                }
+            }
+        }
+
+        std::vector<int> removeEdges = best.removeEdges;
+        for (int k = 0; k < (int) removeEdges.size() && !improved; ++k) {
+            auto [a, b] = g.edges[removeEdges[k]];
+
+            // the vertex informed last on each side of the cycle, below the common ancestor
+            stamp += 1;
+            for (int v = a; v != g.s; v = g.edges[parentEdge[v]].first ^ g.edges[parentEdge[v]].second ^ v) {
+                onPathStamp[v] = stamp;
+            }
+            onPathStamp[g.s] = stamp;
+            int lca = b;
+            int latestB = -1;
+            while (onPathStamp[lca] != stamp) {
+                if (latestB == -1 || informedAt[lca] > informedAt[latestB]) latestB = lca;
+                lca = g.edges[parentEdge[lca]].first ^ g.edges[parentEdge[lca]].second ^ lca;
+            }
+            int latestA = -1;
+            for (int v = a; v != lca; v = g.edges[parentEdge[v]].first ^ g.edges[parentEdge[v]].second ^ v) {
+                if (latestA == -1 || informedAt[v] > informedAt[latestA]) latestA = v;
+            }
+
+            for (int x : {latestA, latestB}) {
+                if (x == -1 || informedAt[x] != (int) best.protocol.rounds.size()) continue;
+                if (numberOfTreesEvaluated >= MAX_EDGE_SWAP_TREES) break;
+                std::vector<int> swapped = removeEdges;
+                swapped[k] = parentEdge[x];
+                if (consider(swapped)) {
+                    improved = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    return best.removeEdges;
+}
+
+/**
+ * The best solution found so far, shared between all threads of the search phase.
+ *
+ * The broadcasting time and the index of the spanning tree on which it was found are
+ * packed into one atomic key (time in the high bits, tree index + 1 in the low bits),
+ * so every thread can read the current bound without locking. Comparing keys breaks
+ * ties in favour of the smaller tree index, which makes the final solution independent
+ * of the number of threads and of the order in which the trees are processed.
+ * The initial solution gets tree index -1.
+ */
+class Incumbent {
+public:
+    Incumbent(int time, const std::vector<int>& removeEdges, long long treeIndex = -1)
+        : key(pack(time, treeIndex)), bestRemoveEdges(removeEdges) {}
+
+    int time() const {
+        return (int) (key.load() >> TREE_INDEX_BITS);
+    }
+
+    long long treeIndex() const {
+        return (long long) (key.load() & TREE_INDEX_MASK) - 1;
+    }
+
+    // the time limit a solution on the given tree must satisfy to replace the incumbent
+    int target(long long treeIndex) const {
+        unsigned long long cur = key.load();
+        long long curTreeIndex = (long long) (cur & TREE_INDEX_MASK) - 1;
+        int curTime = (int) (cur >> TREE_INDEX_BITS);
+        return treeIndex < curTreeIndex ? curTime : curTime - 1;
+    }
+
+    void update(int time, long long treeIndex, const std::vector<int>& removeEdges) {
+        unsigned long long newKey = pack(time, treeIndex);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (newKey < key.load()) {
+            key.store(newKey);
+            bestRemoveEdges = removeEdges;
+        }
+    }
+
+    const std::vector<int>& removeEdges() const {
+        return bestRemoveEdges;
+    }
+
+    // a consistent copy of the incumbent while other threads may still update it
+    void snapshot(int& time, long long& treeIndex, std::vector<int>& removeEdges) {
+        std::lock_guard<std::mutex> lock(mutex);
+        unsigned long long cur = key.load();
+        time = (int) (cur >> TREE_INDEX_BITS);
+        treeIndex = (long long) (cur & TREE_INDEX_MASK) - 1;
+        removeEdges = bestRemoveEdges;
+    }
+
+private:
+    static const int TREE_INDEX_BITS = 36;
+    static const unsigned long long TREE_INDEX_MASK = (1ULL << TREE_INDEX_BITS) - 1;
+
+    static unsigned long long pack(int time, long long treeIndex) {
+        assert(treeIndex + 1 <= (long long) TREE_INDEX_MASK);
+        return ((unsigned long long) time << TREE_INDEX_BITS) | (unsigned long long) (treeIndex + 1);
+    }
+
+    std::atomic<unsigned long long> key;
+    std::mutex mutex;
+    std::vector<int> bestRemoveEdges;
+};
+
+/**
+ * The state of the search phase that is saved in a checkpoint file. The spanning
+ * trees of G2 are always enumerated in the same order, so the search can continue
+ * after the first treesDone trees, all of which have been searched completely.
+ * The graph hash makes sure that a checkpoint is only used for the same input, and
+ * the shard makes sure that treesDone and the incumbent belong to the same trees.
+ */
+struct SearchCheckpoint {
+    uint64_t graphHash = 0;
+    int shardIndex = 0;
+    int numberOfShards = 1;
+    long long treesDone = 0;
+    int time = 0;
+    long long treeIndex = -1;
+    std::vector<int> removeEdges;
+};
+
+const std::string CHECKPOINT_HEADER = "broadcast-cyclomatic-checkpoint 3";
+
+// reads a checkpoint, and returns false if the file does not exist
+bool readCheckpoint(const std::string& fileName, SearchCheckpoint& checkpoint) {
+    std::ifstream in(fileName);
+    if (!in) return false;
+
+    std::string header;
+    std::getline(in, header);
+    int numberOfRemoveEdges = 0;
+    if (header != CHECKPOINT_HEADER
+            || !(in >> checkpoint.graphHash >> checkpoint.shardIndex >> checkpoint.numberOfShards)
+            || !(in >> checkpoint.treesDone)
+            || !(in >> checkpoint.time >> checkpoint.treeIndex >> numberOfRemoveEdges)
+            || numberOfRemoveEdges < 0) {
+        throw std::runtime_error("The checkpoint file " + fileName + " is corrupted.");
+    }
+    checkpoint.removeEdges.resize(numberOfRemoveEdges);
+    for (int& eid : checkpoint.removeEdges) {
+        if (!(in >> eid)) {
+            throw std::runtime_error("The checkpoint file " + fileName + " is corrupted.");
+        }
+    }
+    return true;
+}
+
+// writes a checkpoint to a temporary file first and then renames it, so that an
+// interrupted write never destroys the previous checkpoint
+void writeCheckpoint(const std::string& fileName, const SearchCheckpoint& checkpoint) {
+    std::string tmpFileName = fileName + ".tmp";
+    {
+        std::ofstream out(tmpFileName);
+        out << CHECKPOINT_HEADER << '\n';
+        out << checkpoint.graphHash << ' ' << checkpoint.shardIndex << ' ' << checkpoint.numberOfShards << '\n';
+        out << checkpoint.treesDone << '\n';
+        out << checkpoint.time << ' ' << checkpoint.treeIndex << ' ' << checkpoint.removeEdges.size() << '\n';
+        for (int eid : checkpoint.removeEdges) out << eid << ' ';
+        out << '\n';
+        if (!out) {
+            throw std::runtime_error("Failed to write the checkpoint file " + tmpFileName + ".");
+        }
+    }
+    if (std::rename(tmpFileName.c_str(), fileName.c_str()) != 0) {
+        throw std::runtime_error("Failed to replace the checkpoint file " + fileName + ".");
+    }
+}
+
+// It computes the kernel of g for the feedback edge set S: the set U with its xTrees
+// and xyTrees, and the multigraph G2. It returns the number of interchangeable child
+// edges of G2. The trees hanging off U are peeled with numThreads threads.
+int constructKernel(const Graph& g,
+        const Adjacency& adj,
+        const std::vector<int>& S,
+        int numThreads,
+        Kernel& kernel) {
+    kernel.U = constructU(g, adj, S);
+    const std::vector<int>& U = kernel.U;
+
+    kernel.positionInU.assign(g.n, -1);
+    for (int i = 0; i < (int) U.size(); ++i) {
+        kernel.positionInU[U[i]] = i;
+    }
+
+    std::vector<int> xyPathVertices;
+    std::vector<int> xyPathEdgesInG;
+    preProcessXTreesAndXYTrees(g, adj, U, kernel.positionInU, numThreads, kernel.timeNeededForXTrees,
+        kernel.freeChildrenPositions, kernel.xyTrees, kernel.bh, kernel.dh,
+        kernel.peeledDP, kernel.peeledChildren, xyPathVertices, xyPathEdgesInG);
+
+    constructG2(g, U, kernel.positionInU, kernel.xyTrees, kernel.G2, kernel.correspondingEdgeInG);
+    kernel.firstXYTreeEdge = (int) kernel.correspondingEdgeInG.size();
+    constructKernelTree(g, xyPathVertices, xyPathEdgesInG, kernel);
+    computeLeafSendTimes(kernel);
+    return computeChildClasses(kernel);
+}
+
+// every vertex u in U is informed at the earliest at its distance from the source,
+// and then needs timeNeededForXTrees[u] more rounds for its xTrees alone
+int kernelLowerBound(const Graph& g, const Adjacency& adj, const Kernel& kernel) {
+    std::vector<int> distFromSource = distancesFromSource(g, adj);
+    int lowerBound = broadcastingLowerBound(g, adj);
+    for (int i = 0; i < (int) kernel.U.size(); ++i) {
+        lowerBound = std::max(lowerBound, distFromSource[kernel.U[i]] + kernel.timeNeededForXTrees[i]);
+    }
+    return lowerBound;
+}
+
+// It searches the spanning tree T2 with the given index for solutions that improve
+// the incumbent. The orderings of the group of the source are checked against the
+// incumbent. Every complete ordering is then checked for the whole tree, and its
+// smallest feasible time limit becomes the new incumbent. It returns false if the
+// search was interrupted because outOfTime() returned true.
+template <typename OutOfTime>
+bool searchSpanningTree(const Kernel& kernel,
+        SearchWorkspace& ws,
+        const std::vector<int>& T2,
+        long long treeIndex,
+        int lowerBound,
+        Incumbent& incumbent,
+        const OutOfTime& outOfTime) {
+    setSpanningTree(kernel, T2, ws);
+    spanningTreeLowerBound(kernel, ws);
+    computeInitialC(kernel, ws);
+    sortAllChildren(kernel, ws);
+
+    ws.r[kernel.G2.s] = 0;
+    bool interrupted = false;
+    enumerateGroupOrderings(kernel, ws, kernel.G2.s, 0,
+        [&]() { return incumbent.target(treeIndex); },
+        [&]() {
+            if (outOfTime()) {
+                interrupted = true;
+                return true;
+            }
+            ws.numberOfOrderings += 1;
+            int target = incumbent.target(treeIndex);
+            if (target < lowerBound) return true;
+            int t = minimalFeasibleTime(kernel, ws, lowerBound, target);
+            if (t != -1) {
+                collectRemoveEdges(kernel, ws, t);
+                incumbent.update(t, treeIndex, ws.curRemoveEdges);
+            }
+            return incumbent.target(treeIndex) < lowerBound;
+        });
+    return !interrupted;
+}
+
+// It returns a uniformly random spanning tree of G2 by Wilson's algorithm: a random
+// walk from every vertex that is not in the tree yet, until it hits the tree, with
+// its loops erased, is added to the tree. Like SpanningTreeIterator::nextDirected, it
+// returns directed edges away from the source, every edge after the edge into its
+// start.
+std::vector<int> randomSpanningTree(const Graph& G2,
+        const Adjacency& adj2,
+        std::mt19937& rng) {
+    std::vector<bool> inTree(G2.n, false);
+    std::vector<int> nextEdge(G2.n, -1);
+    std::vector<std::vector<int>> children(G2.n);
+    inTree[G2.s] = true;
+    for (int start = 0; start < G2.n; ++start) {
+        for (int v = start; !inTree[v];) {
+            auto [u, eid] = adj2[v][rng() % adj2[v].size()];
+            nextEdge[v] = eid;
+            v = u;
+        }
+        for (int v = start; !inTree[v];) {
+            inTree[v] = true;
+            auto [a, b] = G2.edges[nextEdge[v]];
+            int parent = a ^ b ^ v;
+            children[parent].push_back(2 * nextEdge[v] + (a == parent ? 0 : 1));
+            v = parent;
+        }
+    }
+
+    std::vector<int> T2;
+    std::vector<int> stack = {G2.s};
+    while (!stack.empty()) {
+        int v = stack.back();
+        stack.pop_back();
+        for (int a : children[v]) {
+            T2.push_back(a);
+            auto [x, y] = G2.edges[a / 2];
+            stack.push_back(a % 2 == 0 ? y : x);
+        }
+    }
+    return T2;
+}
+
+// number of random spanning trees of G2 that are searched for the estimate of the
+// search phase at most, and the time after which no further trees are sampled
+const int ESTIMATE_SAMPLE_TREES = 256;
+const double ESTIMATE_TIME_BUDGET = 0.5;
+const unsigned ESTIMATE_SEED = 20240611;
+
+// It estimates the search phase by searching random spanning trees of G2 on their
+// own, each against the initial solution. The orderings of a tree are counted as the
+// product of |C[u]|! over the members u of every group, summed over the groups,
+// since the groups of closed vertices are enumerated on their own.
+CyclomaticEstimate estimateSearch(const Kernel& kernel,
+        int lowerBound,
+        int initialTime,
+        const std::vector<int>& initialRemoveEdges,
+        int numThreads,
+        int numberOfShards) {
+    const Graph& G2 = kernel.G2;
+    CyclomaticEstimate estimate;
+    estimate.kernelSize = G2.n;
+    estimate.lowerBound = lowerBound;
+    estimate.initialRounds = initialTime;
+    estimate.spanningTreesTotal = countSpanningTrees(G2);
+    if (initialTime == lowerBound) return estimate;
+
+    Adjacency adj2(G2);
+
+    std::mt19937 rng(ESTIMATE_SEED);
+    SearchWorkspace ws(kernel);
+    Timer budgetTimer;
+    auto outOfTime = [&]() { return budgetTimer.elapsed() >= ESTIMATE_TIME_BUDGET; };
+
+    int rejected = 0;
+    long double orderings = 0;
+    double searchTime = 0;
+    while (estimate.spanningTreesSampled < ESTIMATE_SAMPLE_TREES && (estimate.spanningTreesSampled == 0 || !outOfTime())) {
+        std::vector<int> T2 = randomSpanningTree(G2, adj2, rng);
+        estimate.spanningTreesSampled += 1;
+
+        Timer treeTimer;
+        Incumbent incumbent(initialTime, initialRemoveEdges);
+        setSpanningTree(kernel, T2, ws);
+        if (spanningTreeLowerBound(kernel, ws) > incumbent.target(0)) {
+            rejected += 1;
+            searchTime += treeTimer.elapsed();
+            continue;
+        }
+        computeInitialC(kernel, ws);
+        for (int v : ws.order) {
+            if (!ws.isClosed[v]) continue;
+            long double product = 1;
+            for (int u : ws.groups[v]) {
+                for (int i = 2; i <= ws.C[u].size(); ++i) product *= i;
+            }
+            orderings += product;
+        }
+        if (!searchSpanningTree(kernel, ws, T2, 0, lowerBound, incumbent, outOfTime)) {
+            estimate.sampleInterrupted = true;
+        }
+        searchTime += treeTimer.elapsed();
+    }
+
+    int sampled = estimate.spanningTreesSampled;
+    estimate.rejectedShare = (double) rejected / sampled;
+    estimate.orderingsPerTree = rejected < sampled ? orderings / (sampled - rejected) : 0;
+    estimate.secondsPerTree = searchTime / sampled;
+    estimate.predictedSearchTime = (double) (estimate.spanningTreesTotal / numberOfShards
+        * estimate.secondsPerTree / numThreads);
+    return estimate;
+}
+
+void printEstimate(const CyclomaticEstimate& estimate) {
+    std::ostringstream orderings;
+    orderings << std::setprecision(3) << estimate.orderingsPerTree;
+    printInfo("Spanning trees sampled for estimate", estimate.spanningTreesSampled);
+    printInfo("Sampled trees rejected by bound", std::to_string((int) std::lround(100 * estimate.rejectedShare)), "%");
+    printInfo("Child orderings per sampled tree", orderings.str());
+    printInfo("Search time per sampled tree", estimate.secondsPerTree, 7);
+    printInfo(estimate.sampleInterrupted ? "Predicted search phase time (at least)" : "Predicted search phase time",
+        estimate.predictedSearchTime);
+}
+
+// number of spanning trees a search thread takes from the shared iterator at once
+const int SPANNING_TREE_BATCH_SIZE = 16;
+
+// ============= Main Algorithm starts here ==================
+
+BroadcastingProtocol algorithmCyclomatic(const Graph& g, bool verbose) {
+    CyclomaticOptions options;
+    options.verbose = verbose;
+    return algorithmCyclomatic(g, options);
+}
+
+BroadcastingProtocol algorithmCyclomatic(const Graph& g, const CyclomaticOptions& options) {
+    CyclomaticReport report;
+    return algorithmCyclomatic(g, options, report);
+}
+
+BroadcastingProtocol algorithmCyclomatic(const Graph& g, const CyclomaticOptions& options,
+        CyclomaticReport& report) {
+    return algorithmCyclomatic(g, Adjacency(g), options, report);
+}
+
+BroadcastingProtocol algorithmCyclomatic(const Graph& g, const Adjacency& adj,
+        const CyclomaticOptions& options, CyclomaticReport& report) {
+    Timer totalTimer;
+
+    if (options.numberOfShards < 1 || options.shardIndex < 0 || options.shardIndex >= options.numberOfShards) {
+        throw std::invalid_argument("Invalid shard " + std::to_string(options.shardIndex) + "/"
+            + std::to_string(options.numberOfShards) + ".");
+    }
+
+    bool verbose = options.verbose;
+    int numThreads = options.numThreads;
+    if (numThreads <= 0) {
+        numThreads = std::max(1, (int) std::thread::hardware_concurrency());
+    }
+
+    if (verbose) {
+        printHeader("Running the cyclomatic broadcasting algorithm");
+    }
+
+    if ((int) g.edges.size() == g.n - 1) {
+        if (verbose) {
+            printHeader("Input graph is a tree");
+            printHeader("Using linear time tree-specific algorithm");
+        }
+        BroadcastingProtocol ans = solveOnTree(g, {}, adj);
+        report = CyclomaticReport();
+        report.spanningTreesSearched = 1;
+        report.spanningTreesTotal = 1;
+        report.rounds = report.lowerBound = (int) ans.rounds.size();
+        if (verbose) {
+            double totalTime = totalTimer.elapsed();
+            printInfo("Optimal broadcasting rounds", static_cast<unsigned long long>(ans.rounds.size()));
+            printEmptyLine();
+            printInfo("Total algorithm time", totalTime);
+        }
+        return ans;
+    }
+
+    // === Preprocessing Step ===
+    Timer preprocessTimer;
+
+    std::vector<int> S = getMinimalFeedbackEdgeSet(g, adj);
+
+    Kernel kernel;
+    int numberOfInterchangeableChildren = constructKernel(g, adj, S, numThreads, kernel);
+    const std::vector<int>& U = kernel.U;
+    const Graph& G2 = kernel.G2;
+    int lowerBound = kernelLowerBound(g, adj, kernel);
+
+    int numberOfInitialTrees = 0;
+    std::vector<int> initialRemoveEdges = findInitialSolution(g, adj, kernel, S, lowerBound, numberOfInitialTrees);
+    int initialTime = (int) solveOnKernelTree(kernel, initialRemoveEdges).rounds.size();
+
+    // a resumed search starts with the incumbent of the checkpoint, unless the new
+    // initial solution is better, and skips all trees that were searched before
+    SearchCheckpoint checkpoint;
+    checkpoint.graphHash = hashGraph(g);
+    checkpoint.shardIndex = options.shardIndex;
+    checkpoint.numberOfShards = options.numberOfShards;
+    bool resumed = false;
+    if (options.resume && !options.checkpointFile.empty()) {
+        uint64_t graphHash = checkpoint.graphHash;
+        resumed = readCheckpoint(options.checkpointFile, checkpoint);
+        if (resumed && checkpoint.graphHash != graphHash) {
+            throw std::runtime_error("The checkpoint file " + options.checkpointFile
+                + " belongs to a different graph.");
+        }
+        if (resumed && (checkpoint.shardIndex != options.shardIndex
+                || checkpoint.numberOfShards != options.numberOfShards)) {
+            throw std::runtime_error("The checkpoint file " + options.checkpointFile + " belongs to shard "
+                + std::to_string(checkpoint.shardIndex) + "/" + std::to_string(checkpoint.numberOfShards) + ".");
+        }
+    }
+    Incumbent incumbent = resumed && checkpoint.time < initialTime
+        ? Incumbent(checkpoint.time, checkpoint.removeEdges, checkpoint.treeIndex)
+        : Incumbent(initialTime, initialRemoveEdges);
 
     double preprocessTime = preprocessTimer.elapsed();
 
     // === Search Phase ===
     Timer searchTimer;
 
-    long long numberOfSpanningTrees = 0;
-    long long numberOfOrderings = 0;
+    std::atomic<long long> numberOfSpanningTrees(0);
+    std::atomic<long long> numberOfOrderings(0);
+    std::atomic<long long> numberOfPrefixesVisited(0);
+    std::atomic<long long> numberOfPrefixesPruned(0);
+    std::atomic<long long> numberOfSubtreeSearches(0);
+    std::atomic<long long> numberOfSpanningTreesRejected(0);
+    std::atomic<long long> numberOfSpanningTreesSearched(0);
+
+    // with a time limit the search stops as soon as it runs out of time, and then
+    // the incumbent is returned as it is
+    std::atomic<bool> timeLimitReached(false);
+    auto outOfTime = [&]() {
+        if (options.timeLimit > 0 && !timeLimitReached.load() && totalTimer.elapsed() >= options.timeLimit) {
+            timeLimitReached = true;
+        }
+        return timeLimitReached.load();
+    };
+
+    // the spanning trees are numbered in the order of the iterator and handed out
+    // in small batches, so that idle threads always pick up the next unprocessed trees.
+    // No more trees are handed out once none of them can improve the incumbent,
+    // because it already meets the lower bound, or once the trees below the spanning
+    // tree limit are handed out. Unlike the time limit, the latter lets the threads
+    // finish the trees they already have.
+    SpanningTreeIterator spanningTreeIterator(G2, G2.s);
+    long long nextTreeIndex = 0;
+    bool spanningTreeLimitReached = false;
+    std::mutex spanningTreeMutex;
+
+    if (resumed) {
+        while (nextTreeIndex < checkpoint.treesDone && spanningTreeIterator.hasNext()) {
+            spanningTreeIterator.next();
+            nextTreeIndex += 1;
+        }
+        numberOfSpanningTreesSearched += nextTreeIndex;
+    }
+    long long treesDoneBeforeResume = nextTreeIndex;
+
+    // batches that are searched completely are collected until they extend the prefix
+    // of searched trees, which is what a checkpoint records
+    long long treesDone = nextTreeIndex;
+    std::map<long long, long long> batchesDone;
+    Timer checkpointTimer;
+
+    auto saveCheckpoint = [&]() {
+        checkpoint.treesDone = treesDone;
+        incumbent.snapshot(checkpoint.time, checkpoint.treeIndex, checkpoint.removeEdges);
+        writeCheckpoint(options.checkpointFile, checkpoint);
+        checkpointTimer.reset();
+    };
+
+    auto finishSpanningTrees = [&](long long firstTreeIndex, long long numberOfTrees) {
+        std::lock_guard<std::mutex> lock(spanningTreeMutex);
+        batchesDone[firstTreeIndex] = numberOfTrees;
+        while (!batchesDone.empty() && batchesDone.begin()->first == treesDone) {
+            treesDone += batchesDone.begin()->second;
+            batchesDone.erase(batchesDone.begin());
+        }
+        if (!options.checkpointFile.empty() && checkpointTimer.elapsed() >= options.checkpointInterval) {
+            saveCheckpoint();
+        }
+    };
+
+    auto takeSpanningTrees = [&](std::vector<std::vector<int>>& batch) {
+        std::lock_guard<std::mutex> lock(spanningTreeMutex);
+        batch.clear();
+        if (incumbent.target(nextTreeIndex) < lowerBound) return nextTreeIndex;
+        if (spanningTreeIterator.hasNext() && outOfTime()) return nextTreeIndex;
+        long long treeLimit = options.spanningTreeLimit;
+        if (treeLimit > 0 && nextTreeIndex >= treeLimit && spanningTreeIterator.hasNext()) {
+            spanningTreeLimitReached = true;
+            return nextTreeIndex;
+        }
+        while ((int) batch.size() < SPANNING_TREE_BATCH_SIZE && spanningTreeIterator.hasNext()
+                && (treeLimit <= 0 || nextTreeIndex + (long long) batch.size() < treeLimit)) {
+            batch.push_back(spanningTreeIterator.nextDirected());
+        }
+        long long firstTreeIndex = nextTreeIndex;
+        nextTreeIndex += (long long) batch.size();
+        return firstTreeIndex;
+    };
 
-    SpanningTreeIterator spanningTreeIterator(G2);
-    while (spanningTreeIterator.hasNext()) {
-        std::vector<int> T2 = spanningTreeIterator.next();
-        numberOfSpanningTrees += 1;
-
-        std::vector<bool> inT2(G2.edges.size(), false);
-        for (int i : T2) inT2[i] = true;
-
-        std::vector<std::vector<std::pair<int, int>>> C;
-        std::vector<bool> usedXYTrees;
-        computeInitialCAndUsedXYTrees(G2, T2, U, xyTrees, positionInU, C, usedXYTrees);
-
-        std::function<void(int)> enumerateAllOrderings = [&](int i) {
-            if (i == (int) C.size()) {
-                numberOfOrderings += 1;
-                while (bestBroadcastingTime >= 1) {
-                    std::vector<int> curRemoveEdges;
-                    if (!isFeasible(G2, correspondingEdgeInG, inT2, U, xyTrees,
-                        usedXYTrees, timeNeededForXTrees, freeChildrenPositions, C, bh, dh,
-                        dhRemoveEdge, curRemoveEdges, bestBroadcastingTime -1)) break;
-                    bestBroadcastingTime -= 1;
-                    bestRemoveEdges = curRemoveEdges;
+    auto searchSpanningTrees = [&]() {
+        long long localSpanningTrees = 0;
+        long long localSpanningTreesSearched = 0;
+        std::vector<std::vector<int>> batch;
+        std::vector<std::pair<int, int>> promisingTrees;
+        SearchWorkspace ws(kernel);
+
+        while (true) {
+            long long firstTreeIndex = takeSpanningTrees(batch);
+            if (batch.empty()) break;
+
+            // the trees of the batch that are not rejected by their lower bound are
+            // searched in the order of their bounds, so that the most promising trees
+            // lower the incumbent first. The result does not depend on this order.
+            promisingTrees.clear();
+            for (int b = 0; b < (int) batch.size(); ++b) {
+                long long treeIndex = firstTreeIndex + b;
+                if (treeIndex % options.numberOfShards != options.shardIndex) continue;
+                if (incumbent.target(treeIndex) < lowerBound) continue;
+                localSpanningTrees += 1;
+
+                setSpanningTree(kernel, batch[b], ws);
+                int bound = spanningTreeLowerBound(kernel, ws);
+                if (bound > incumbent.target(treeIndex)) {
+                    ws.numberOfSpanningTreesRejected += 1;
+                    localSpanningTreesSearched += 1;
+                    continue;
                 }
+                promisingTrees.emplace_back(bound, b);
             }
-            else {
-                do {
-                    enumerateAllOrderings(i + 1);
+            std::sort(promisingTrees.begin(), promisingTrees.end());
+
+            bool batchDone = true;
+            for (auto [bound, b] : promisingTrees) {
+                long long treeIndex = firstTreeIndex + b;
+                if (incumbent.target(treeIndex) < lowerBound) continue;
+                if (outOfTime()) {
+                    batchDone = false;
+                    break;
+                }
+                if (bound > incumbent.target(treeIndex)) {
+                    ws.numberOfSpanningTreesRejected += 1;
+                    localSpanningTreesSearched += 1;
+                    continue;
+                }
+                if (!searchSpanningTree(kernel, ws, batch[b], treeIndex, lowerBound, incumbent, outOfTime)) {
+                    batchDone = false;
+                    break;
                 }
-                while (std::next_permutation(C[i].begin(), C[i].end()));
+                localSpanningTreesSearched += 1;
             }
-        };
-        enumerateAllOrderings(0);
+            if (batchDone) finishSpanningTrees(firstTreeIndex, (long long) batch.size());
+        }
+
+        numberOfSpanningTrees += localSpanningTrees;
+        numberOfSpanningTreesSearched += localSpanningTreesSearched;
+        numberOfOrderings += ws.numberOfOrderings;
+        numberOfPrefixesVisited += ws.numberOfPrefixesVisited;
+        numberOfPrefixesPruned += ws.numberOfPrefixesPruned;
+        numberOfSubtreeSearches += ws.numberOfSubtreeSearches;
+        numberOfSpanningTreesRejected += ws.numberOfSpanningTreesRejected;
+    };
+
+    std::vector<std::thread> searchThreads;
+    for (int i = 1; i < numThreads; ++i) {
+        searchThreads.emplace_back(searchSpanningTrees);
+    }
+    searchSpanningTrees();
+    for (std::thread& thread : searchThreads) {
+        thread.join();
+    }
+
+    if (!options.checkpointFile.empty()) {
+        saveCheckpoint();
     }
 
     double searchTime = searchTimer.elapsed();
     Timer reconstructTimer;
 
     // === Constructing protocol ===
-    BroadcastingProtocol ans = solveOnTree(g, bestRemoveEdges);
-    assert((int) ans.rounds.size() == bestBroadcastingTime);
+    BroadcastingProtocol ans = solveOnKernelTree(kernel, incumbent.removeEdges());
+    assert((int) ans.rounds.size() == incumbent.time());
+
+    // the search proves optimality unless it was stopped early by the time limit or
+    // the spanning tree limit, or it only covered one shard of the spanning trees
+    report.rounds = incumbent.time();
+    report.searchCompleted = !timeLimitReached.load() && !spanningTreeLimitReached;
+    report.optimal = (report.searchCompleted && options.numberOfShards == 1) || report.rounds == lowerBound;
+    report.lowerBound = report.optimal ? report.rounds : lowerBound;
+    report.treeIndex = incumbent.treeIndex();
+    report.removeEdges = incumbent.removeEdges();
+    report.spanningTreesSearched = numberOfSpanningTreesSearched.load();
+    report.spanningTreesTotal = countSpanningTrees(G2);
 
     if (verbose) {
         double reconstructTime = reconstructTimer.elapsed();
         double totalTime = totalTimer.elapsed();
 
         printInfo("Size of U", static_cast<unsigned long long>(U.size()));
-        printInfo("Spanning trees enumerated", numberOfSpanningTrees);
-        printInfo("Child orderings tried", numberOfOrderings);
-        printInfo("Optimal broadcasting rounds", static_cast<unsigned long long>(ans.rounds.size()));
+        printInfo("Interchangeable child edges", numberOfInterchangeableChildren);
+        printInfo("Lower bound on rounds", lowerBound);
+        printInfo("Initial trees evaluated", numberOfInitialTrees);
+        printInfo("Initial upper bound on rounds", initialTime);
+        printInfo("Search threads", numThreads);
+        if (resumed) {
+            printInfo("Spanning trees done before resume", treesDoneBeforeResume);
+        }
+        printInfo("Spanning trees enumerated", numberOfSpanningTrees.load());
+        printInfo("Spanning trees rejected by bound", numberOfSpanningTreesRejected.load());
+        printInfo("Partial orderings visited", numberOfPrefixesVisited.load());
+        printInfo("Partial orderings pruned", numberOfPrefixesPruned.load());
+        printInfo("Independent subtrees solved", numberOfSubtreeSearches.load());
+        printInfo("Child orderings tried", numberOfOrderings.load());
+
+        std::ostringstream totalTrees;
+        totalTrees << std::fixed << std::setprecision(0) << report.spanningTreesTotal;
+        std::ostringstream searchedShare;
+        searchedShare << std::fixed << std::setprecision(2)
+            << 100.0L * report.spanningTreesSearched / report.spanningTreesTotal;
+        printInfo("Spanning trees of G2", totalTrees.str());
+        printInfo("Spanning trees searched", searchedShare.str(), "%");
+
+        if (report.optimal) {
+            printInfo("Optimal broadcasting rounds", static_cast<unsigned long long>(ans.rounds.size()));
+        }
+        else {
+            if (options.numberOfShards > 1) {
+                printInfo("Shard", std::to_string(options.shardIndex) + "/" + std::to_string(options.numberOfShards));
+            }
+            printInfo("Time limit reached", std::string(timeLimitReached.load() ? "yes" : "no"));
+            printInfo("Best broadcasting rounds found", static_cast<unsigned long long>(ans.rounds.size()));
+            printInfo("Lower bound on optimal rounds", report.lowerBound);
+            printInfo("Optimality gap", report.rounds - report.lowerBound);
+        }
         printEmptyLine();
         printInfo("Preprocessing time", preprocessTime);
         printInfo("Search phase time", searchTime);
@@ -795,4 +2656,52 @@ BroadcastingProtocol algorithmCyclomatic(const Graph& g, bool verbose) {
     return ans;
 }
 
+CyclomaticEstimate estimateCyclomatic(const Graph& g, const CyclomaticOptions& options) {
+    return estimateCyclomatic(g, Adjacency(g), options);
+}
+
+CyclomaticEstimate estimateCyclomatic(const Graph& g, const Adjacency& adj, const CyclomaticOptions& options) {
+    if (options.numberOfShards < 1 || options.shardIndex < 0 || options.shardIndex >= options.numberOfShards) {
+        throw std::invalid_argument("Invalid shard " + std::to_string(options.shardIndex) + "/"
+            + std::to_string(options.numberOfShards) + ".");
+    }
+    int numThreads = options.numThreads;
+    if (numThreads <= 0) {
+        numThreads = std::max(1, (int) std::thread::hardware_concurrency());
+    }
+
+    if ((int) g.edges.size() == g.n - 1) {
+        CyclomaticEstimate estimate;
+        estimate.lowerBound = estimate.initialRounds = (int) solveOnTree(g, {}, adj).rounds.size();
+        estimate.spanningTreesTotal = 1;
+        if (options.verbose) {
+            printHeader("Input graph is a tree");
+            printInfo("Predicted search phase time", 0.0);
+        }
+        return estimate;
+    }
+
+    std::vector<int> S = getMinimalFeedbackEdgeSet(g, adj);
+    Kernel kernel;
+    constructKernel(g, adj, S, numThreads, kernel);
+    int lowerBound = kernelLowerBound(g, adj, kernel);
+
+    int numberOfInitialTrees = 0;
+    std::vector<int> initialRemoveEdges = findInitialSolution(g, adj, kernel, S, lowerBound, numberOfInitialTrees);
+    int initialTime = (int) solveOnKernelTree(kernel, initialRemoveEdges).rounds.size();
+
+    CyclomaticEstimate estimate = estimateSearch(kernel, lowerBound, initialTime, initialRemoveEdges,
+        numThreads, options.numberOfShards);
+    if (options.verbose) {
+        std::ostringstream totalTrees;
+        totalTrees << std::fixed << std::setprecision(0) << estimate.spanningTreesTotal;
+        printInfo("Size of U", estimate.kernelSize);
+        printInfo("Lower bound on rounds", lowerBound);
+        printInfo("Initial upper bound on rounds", initialTime);
+        printInfo("Spanning trees of G2", totalTrees.str());
+        printEstimate(estimate);
+    }
+    return estimate;
+}
+
 } // namespace broadcast
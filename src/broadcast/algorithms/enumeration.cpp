@@ -19,6 +19,7 @@ BroadcastingProtocol algorithmEnumerateAllTrees(const Graph& g, bool verbose) {
     long long numberOfSpanningTrees = 0;
 
     SpanningTreeIterator iter(g);
+    Adjacency adj(g);
 
     // enumerate all spanning trees
     while (iter.hasNext()) {
@@ -39,7 +40,7 @@ BroadcastingProtocol algorithmEnumerateAllTrees(const Graph& g, bool verbose) {
         }
 
         // solve broadcasting problem on current spanning tree
-        BroadcastingProtocol cur = solveOnTree(g, ignoreEdges);
+        BroadcastingProtocol cur = solveOnTree(g, ignoreEdges, adj);
 
         // update the best solution
         if (cur.rounds.size() < best.rounds.size()) {
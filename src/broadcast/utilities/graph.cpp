@@ -1,11 +1,9 @@
 #include <broadcast/utilities/graph.hpp>
-#include <broadcast/utilities/hash.hpp>
 
 #include <algorithm>
 #include <iostream>
 #include <queue>
 #include <stdexcept>
-#include <unordered_set>
 #include <vector>
 
 namespace broadcast {
@@ -59,6 +57,28 @@ void printGraph(const Graph& g, std::ostream& out) {
     }
 }
 
+Adjacency::Adjacency(const Graph& g) : offset(g.n + 1, 0), neighbour(2 * g.edges.size()), edgeId(2 * g.edges.size()) {
+    // offset[v] is first the end of the entries of v, and it moves to their start
+    // while they are filled in from the last edge to the first
+    for (const auto& [u, v] : g.edges) {
+        offset[u] += 1;
+        offset[v] += 1;
+    }
+    for (int v = 1; v < g.n; ++v) {
+        offset[v] += offset[v - 1];
+    }
+    offset[g.n] = (int) neighbour.size();
+    for (int i = (int) g.edges.size() - 1; i >= 0; --i) {
+        auto [u, v] = g.edges[i];
+        int pu = --offset[u];
+        neighbour[pu] = v;
+        edgeId[pu] = i;
+        int pv = --offset[v];
+        neighbour[pv] = u;
+        edgeId[pv] = i;
+    }
+}
+
 bool isSimpleAndConnected(const Graph& g) {
     if (g.n <= 0) return false; // Need at least one vertex
     if (g.s < 0 || g.s >= g.n) return false; // Invalid source
@@ -66,24 +86,23 @@ bool isSimpleAndConnected(const Graph& g) {
     for (const auto& [u, v] : g.edges) {
         if (u < 0 || u >= g.n) return false; // Invalid vertex
         if (v < 0 || v >= g.n) return false; // Invalid vertex
-        if (u == v) return false; // Self-loop
     }
 
-    // Check for duplicates
-    std::unordered_set<std::pair<int, int>, customHash> edgeSet;
-    for (auto [u, v] : g.edges) {
-        if (u > v) std::swap(u, v); // Normalize edge
-        edgeSet.emplace(u, v);
-    }
-    if (edgeSet.size() != g.edges.size()) {
-        return false; // Duplicate must exist
-    }
+    return isSimpleAndConnected(g, Adjacency(g));
+}
 
-    // Build adjacency list
-    std::vector<std::vector<int>> adj(g.n);
-    for (const auto& [u, v] : g.edges) {
-        adj[u].push_back(v);
-        adj[v].push_back(u);
+bool isSimpleAndConnected(const Graph& g, const Adjacency& adj) {
+    if (g.n <= 0) return false; // Need at least one vertex
+    if (g.s < 0 || g.s >= g.n) return false; // Invalid source
+
+    // Check for self-loops and duplicates, marking the neighbours of every vertex
+    std::vector<int> seenFrom(g.n, -1);
+    for (int u = 0; u < g.n; ++u) {
+        for (auto [v, eid] : adj[u]) {
+            if (v == u) return false; // Self-loop
+            if (seenFrom[v] == u) return false; // Duplicate
+            seenFrom[v] = u;
+        }
     }
 
     // BFS to check connectivity
@@ -94,7 +113,7 @@ bool isSimpleAndConnected(const Graph& g) {
 
     while (!q.empty()) {
         int u = q.front(); q.pop();
-        for (int v : adj[u]) {
+        for (auto [v, eid] : adj[u]) {
             if (!visited[v]) {
                 visited[v] = true;
                 q.push(v);
@@ -105,4 +124,21 @@ bool isSimpleAndConnected(const Graph& g) {
     return std::all_of(visited.begin(), visited.end(), [](bool v) { return v; });
 }
 
+uint64_t hashGraph(const Graph& g) {
+    // splitmix64 finalizer, applied to the running hash and every value in turn
+    auto mix = [](uint64_t x) {
+        x += 0x9e3779b97f4a7c15;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+        return x ^ (x >> 31);
+    };
+    uint64_t h = mix(uint64_t(g.n));
+    h = mix(h ^ uint64_t(g.s));
+    h = mix(h ^ uint64_t(g.edges.size()));
+    for (const auto& [u, v] : g.edges) {
+        h = mix(h ^ ((uint64_t(uint32_t(u)) << 32) | uint32_t(v)));
+    }
+    return h;
+}
+
 } // namespace broadcast
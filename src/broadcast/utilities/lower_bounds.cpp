@@ -0,0 +1,48 @@
+#include <broadcast/utilities/lower_bounds.hpp>
+
+#include <algorithm>
+#include <queue>
+
+namespace broadcast {
+
+std::vector<int> distancesFromSource(const Graph& g) {
+    return distancesFromSource(g, Adjacency(g));
+}
+
+std::vector<int> distancesFromSource(const Graph& g, const Adjacency& adj) {
+    std::vector<int> dist(g.n, -1);
+    std::queue<int> q;
+    dist[g.s] = 0;
+    q.push(g.s);
+    while (!q.empty()) {
+        int v = q.front();
+        q.pop();
+        for (auto [u, eid] : adj[v]) {
+            if (dist[u] == -1) {
+                dist[u] = dist[v] + 1;
+                q.push(u);
+            }
+        }
+    }
+    return dist;
+}
+
+int logarithmicLowerBound(int n) {
+    int k = 0;
+    while ((1LL << k) < n) {
+        k += 1;
+    }
+    return k;
+}
+
+int broadcastingLowerBound(const Graph& g) {
+    return broadcastingLowerBound(g, Adjacency(g));
+}
+
+int broadcastingLowerBound(const Graph& g, const Adjacency& adj) {
+    std::vector<int> dist = distancesFromSource(g, adj);
+    int eccentricity = *std::max_element(dist.begin(), dist.end());
+    return std::max(logarithmicLowerBound(g.n), eccentricity);
+}
+
+} // namespace broadcast
@@ -0,0 +1,123 @@
+#include <broadcast/utilities/partial_result.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace broadcast {
+
+bool PartialResult::operator==(const PartialResult& other) const {
+    return graphHash == other.graphHash && shardIndex == other.shardIndex
+        && numberOfShards == other.numberOfShards && rounds == other.rounds
+        && treeIndex == other.treeIndex && lowerBound == other.lowerBound
+        && completed == other.completed && removeEdges == other.removeEdges;
+}
+
+PartialResult readPartialResult(std::istream& in) {
+    PartialResult result;
+    if (!(in >> result.graphHash)) {
+        throw std::runtime_error("Failed to read graph hash.");
+    }
+    if (!(in >> result.shardIndex >> result.numberOfShards)) {
+        throw std::runtime_error("Failed to read shard.");
+    }
+    if (result.numberOfShards < 1 || result.shardIndex < 0 || result.shardIndex >= result.numberOfShards) {
+        throw std::runtime_error("Invalid shard " + std::to_string(result.shardIndex) + "/"
+            + std::to_string(result.numberOfShards) + ".");
+    }
+
+    int completed;
+    if (!(in >> result.rounds >> result.treeIndex >> result.lowerBound >> completed)) {
+        throw std::runtime_error("Failed to read solution.");
+    }
+    result.completed = completed != 0;
+
+    int m;
+    if (!(in >> m) || m < 0) {
+        throw std::runtime_error("Failed to read number of removed edges.");
+    }
+    result.removeEdges.resize(m);
+    for (int i = 0; i < m; ++i) {
+        if (!(in >> result.removeEdges[i])) {
+            throw std::runtime_error("Failed to read removed edge " + std::to_string(i + 1) + ".");
+        }
+        if (result.removeEdges[i] < 0) {
+            throw std::runtime_error("Invalid removed edge " + std::to_string(result.removeEdges[i]) + ".");
+        }
+    }
+
+    std::vector<int> sorted = result.removeEdges;
+    std::sort(sorted.begin(), sorted.end());
+    for (int i = 1; i < m; ++i) {
+        if (sorted[i] == sorted[i - 1]) {
+            throw std::runtime_error("Removed edge " + std::to_string(sorted[i]) + " is given twice.");
+        }
+    }
+    return result;
+}
+
+void checkRemoveEdges(const PartialResult& result, const Graph& g) {
+    for (int eid : result.removeEdges) {
+        if (eid < 0 || eid >= (int) g.edges.size()) {
+            throw std::runtime_error("Invalid removed edge " + std::to_string(eid) + ".");
+        }
+    }
+    long long expected = (long long) g.edges.size() - g.n + 1;
+    if ((long long) result.removeEdges.size() != expected) {
+        throw std::runtime_error("Expected " + std::to_string(expected) + " removed edges, but got "
+            + std::to_string(result.removeEdges.size()) + ".");
+    }
+}
+
+void printPartialResult(const PartialResult& result, std::ostream& out) {
+    out << result.graphHash << '\n';
+    out << result.shardIndex << ' ' << result.numberOfShards << '\n';
+    out << result.rounds << ' ' << result.treeIndex << ' ' << result.lowerBound << ' '
+        << (result.completed ? 1 : 0) << '\n';
+    out << result.removeEdges.size();
+    for (int eid : result.removeEdges) out << ' ' << eid;
+    out << '\n';
+}
+
+PartialResult mergePartialResults(const std::vector<PartialResult>& results) {
+    if (results.empty()) {
+        throw std::runtime_error("No partial results to merge.");
+    }
+
+    int numberOfShards = results[0].numberOfShards;
+    std::vector<bool> seen(numberOfShards, false);
+    for (const PartialResult& result : results) {
+        if (result.graphHash != results[0].graphHash) {
+            throw std::runtime_error("The partial results belong to different graphs.");
+        }
+        if (result.numberOfShards != numberOfShards) {
+            throw std::runtime_error("The partial results belong to searches with different numbers of shards.");
+        }
+        if (seen[result.shardIndex]) {
+            throw std::runtime_error("Shard " + std::to_string(result.shardIndex) + " is given twice.");
+        }
+        seen[result.shardIndex] = true;
+    }
+    for (int i = 0; i < numberOfShards; ++i) {
+        if (!seen[i]) {
+            throw std::runtime_error("Shard " + std::to_string(i) + " is missing.");
+        }
+    }
+
+    PartialResult merged = results[0];
+    for (const PartialResult& result : results) {
+        if (std::make_pair(result.rounds, result.treeIndex) < std::make_pair(merged.rounds, merged.treeIndex)) {
+            merged.rounds = result.rounds;
+            merged.treeIndex = result.treeIndex;
+            merged.removeEdges = result.removeEdges;
+        }
+        merged.lowerBound = std::max(merged.lowerBound, result.lowerBound);
+        merged.completed = merged.completed && result.completed;
+    }
+    merged.shardIndex = 0;
+    merged.numberOfShards = 1;
+    return merged;
+}
+
+} // namespace broadcast
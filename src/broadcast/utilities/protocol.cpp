@@ -1,11 +1,9 @@
 #include <broadcast/utilities/protocol.hpp>
-#include <broadcast/utilities/hash.hpp>
 
 #include <algorithm>
 #include <iostream>
 #include <stdexcept>
 #include <string>
-#include <unordered_set>
 #include <vector>
 
 namespace broadcast {
@@ -64,14 +62,13 @@ void printBroadcastingProtocol(const BroadcastingProtocol& bp, std::ostream& out
 }
 
 bool isValidBroadcastingProtocol(const BroadcastingProtocol& bp, const Graph& g) {
-    std::vector<bool> informed(g.n, false);
-    informed[g.s] = true;
+    return isValidBroadcastingProtocol(bp, g, Adjacency(g));
+}
 
-    std::unordered_set<std::pair<int, int>, customHash> edgeSet;
-    for (auto [u, v] : g.edges) {
-        if (u > v) std::swap(u, v); // Normalize edge
-        edgeSet.emplace(u, v);
-    }
+bool isValidBroadcastingProtocol(const BroadcastingProtocol& bp, const Graph& g, const Adjacency& adj) {
+    // informedRound[v] = round in which v is informed (-1 if not informed yet)
+    std::vector<int> informedRound(g.n, -1);
+    informedRound[g.s] = 0;
 
     // lastActiveRound[u] = last round that u informed a neighbour
     std::vector<int> lastActiveRound(g.n, -1);
@@ -81,22 +78,25 @@ bool isValidBroadcastingProtocol(const BroadcastingProtocol& bp, const Graph& g)
             return false;
         }
 
+        // a vertex informed in round i + 1 can only send from the next round on
         for (const auto& [u, v] : bp.rounds[i]) {
             if (u < 0 || u >= g.n) return false;
             if (v < 0 || v >= g.n) return false;
-            if (!informed[u]) return false;
-            if (informed[v]) return false;
-            if (edgeSet.find(std::make_pair(std::min(u, v), std::max(u, v))) == edgeSet.end()) return false;
+            if (informedRound[u] == -1 || informedRound[u] > i) return false;
+            if (informedRound[v] != -1) return false;
             if (lastActiveRound[u] == i) return false;
+            // every vertex is informed once, so the edges of each vertex are scanned once
+            bool isEdge = false;
+            for (auto [w, eid] : adj[v]) {
+                if (w == u) isEdge = true;
+            }
+            if (!isEdge) return false;
             lastActiveRound[u] = i;
-        }
-
-        for (const auto& [u, v] : bp.rounds[i]) {
-            informed[v] = true;
+            informedRound[v] = i + 1;
         }
     }
 
-    return std::all_of(informed.begin(), informed.end(), [](bool v) { return v; });
+    return std::all_of(informedRound.begin(), informedRound.end(), [](int round) { return round != -1; });
 }
 
 } // namespace broadcast
@@ -11,19 +11,24 @@ BroadcastingProtocol solveOnTree(const Graph& g, const std::vector<int>& ignoreE
         BroadcastingProtocol ans;
         return ans;
     }
+    return solveOnTree(g, ignoreEdges, Adjacency(g));
+}
+
+BroadcastingProtocol solveOnTree(const Graph& g, const std::vector<int>& ignoreEdges, const Adjacency& adj) {
+    if (g.n == 1) {
+        BroadcastingProtocol ans;
+        return ans;
+    }
 
     std::vector<bool> edgeOk(g.edges.size(), true);
     for (int eid : ignoreEdges) edgeOk[eid] = false;
 
-    std::vector<std::vector<int>> adj(g.n);
     std::vector<int> deg(g.n, 0);
 
-    // build adjacency lists and list of degrees of all vertices
+    // list of degrees of all vertices, without the ignored edges
     for (int i = 0; i < (int) g.edges.size(); ++i) {
         if (edgeOk[i]) {
             auto [u, v] = g.edges[i];
-            adj[u].push_back(v);
-            adj[v].push_back(u);
             deg[u] += 1;
             deg[v] += 1;
         }
@@ -37,32 +42,59 @@ BroadcastingProtocol solveOnTree(const Graph& g, const std::vector<int>& ignoreE
 
     // dp[v] = time needed to inform subtree rooted at v
     std::vector<int> dp(g.n, -1);
-
-    // leavesByTime[t] = list of all vertices v, dp[v] = t 
-    std::vector<std::vector<int>> leavesByTime(g.n);
-
-    // children[v] is a list of all children of v. The children are
-    // initially inserted in increasing number of dp[v], but later
-    // their order is reversed
-    std::vector<std::vector<int>> children(g.n);
+    std::vector<int> parent(g.n, -1);
+
+    // the leaves v with dp[v] = t form a queue from levelHead[t] to levelTail[t],
+    // linked by nextLeaf
+    std::vector<int> levelHead(g.n, -1);
+    std::vector<int> levelTail(g.n, -1);
+    std::vector<int> nextLeaf(g.n, -1);
+    auto pushLeaf = [&](int v) {
+        int t = dp[v];
+        if (levelTail[t] == -1) levelHead[t] = v;
+        else nextLeaf[levelTail[t]] = v;
+        levelTail[t] = v;
+    };
+
+    // the children of v are stored in childBuffer from childBegin[v] to
+    // childEnd[v], in one slot per edge of v. They are found in increasing
+    // order of dp, so they are written from the back, and end up in
+    // decreasing order of dp
+    std::vector<int> childEnd(g.n);
+    for (int v = 0, end = 0; v < g.n; ++v) {
+        end += deg[v];
+        childEnd[v] = end;
+    }
+    std::vector<int> childBegin = childEnd;
+    std::vector<int> childBuffer(childEnd.empty() ? 0 : childEnd.back());
+
+    // computes dp[u] from its children
+    auto computeDP = [&](int u) {
+        dp[u] = 0;
+        for (int i = childBegin[u]; i < childEnd[u]; ++i) {
+            dp[u] = std::max(dp[u], dp[childBuffer[i]] + 1 + i - childBegin[u]);
+        }
+    };
 
     for (int v = 0; v < g.n; ++v) {
         if (deg[v] == 1 && v != g.s) {
             dp[v] = 0;
-            leavesByTime[dp[v]].push_back(v);
+            pushLeaf(v);
         }
     }
 
     // iterate over all leaves v in increasing dp[v]
     for (int t = 0; t < g.n; ++t) {
-        for (int v : leavesByTime[t]) {
+        for (int v = levelHead[t]; v != -1; v = nextLeaf[v]) {
             if (deg[v] != 1) {
                 throw std::runtime_error("The given graph is not connected.");
             }
-            for (int u : adj[v]) {
-                if (deg[u] == 0) continue;
-                // add v to the list of children of u
-                children[u].push_back(v);
+            for (auto [u, eid] : adj[v]) {
+                if (!edgeOk[eid] || deg[u] == 0) continue;
+                // add v to the front of the children of u
+                childBegin[u] -= 1;
+                childBuffer[childBegin[u]] = v;
+                parent[v] = u;
 
                 // delete the leaf v
                 deg[u] -= 1;
@@ -70,13 +102,8 @@ BroadcastingProtocol solveOnTree(const Graph& g, const std::vector<int>& ignoreE
 
                 // check if u becomes a leaf after the deletion of v
                 if (deg[u] == 1 && u != g.s) {
-                    // compute dp[u]
-                    std::reverse(children[u].begin(), children[u].end());
-                    dp[u] = 0;
-                    for (int i = 0; i < (int) children[u].size(); ++i) {
-                        dp[u] = std::max(dp[u], dp[children[u][i]] + 1 + i);
-                    }
-                    leavesByTime[dp[u]].push_back(u);
+                    computeDP(u);
+                    pushLeaf(u);
                 }
             }
         }
@@ -89,10 +116,25 @@ BroadcastingProtocol solveOnTree(const Graph& g, const std::vector<int>& ignoreE
     }
 
     // compute dp[source]
-    std::reverse(children[g.s].begin(), children[g.s].end());
-    dp[g.s] = 0;
-    for (int i = 0; i < (int) children[g.s].size(); ++i) {
-        dp[g.s] = std::max(dp[g.s], dp[children[g.s][i]] + 1 + i);
+    computeDP(g.s);
+
+    // the children of every vertex are reordered by decreasing dp and then by
+    // vertex, with a counting sort by dp, so that the protocol only depends on
+    // the tree and not on the order of the edges
+    std::vector<int> firstWithNeed(g.n + 1, 0);
+    for (int v = 0; v < g.n; ++v) {
+        if (v != g.s) firstWithNeed[g.n - dp[v]] += 1;
+    }
+    for (int i = 0; i < g.n; ++i) {
+        firstWithNeed[i + 1] += firstWithNeed[i];
+    }
+    std::vector<int> byNeed(g.n - 1);
+    for (int v = 0; v < g.n; ++v) {
+        if (v != g.s) byNeed[firstWithNeed[g.n - 1 - dp[v]]++] = v;
+    }
+    std::vector<int> nextChild = childBegin;
+    for (int v : byNeed) {
+        childBuffer[nextChild[parent[v]]++] = v;
     }
 
     // t[v] = time that v is informed in an optimal broadcasting protocol
@@ -110,8 +152,8 @@ BroadcastingProtocol solveOnTree(const Graph& g, const std::vector<int>& ignoreE
         int v = st.back();
         st.pop_back();
         // v informs its children u in decreasing order of dp[u]
-        for (int i = 0; i < (int) children[v].size(); ++i) {
-            int u = children[v][i];
+        for (int i = 0; i < childEnd[v] - childBegin[v]; ++i) {
+            int u = childBuffer[childBegin[v] + i];
             ans.rounds[t[v] + i].emplace_back(v, u);
             t[u] = t[v] + 1 + i;
             st.push_back(u);
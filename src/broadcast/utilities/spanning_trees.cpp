@@ -1,13 +1,14 @@
 #include <broadcast/utilities/spanning_trees.hpp>
 
-#include <functional>
+#include <cmath>
+#include <utility>
 
 namespace broadcast {
 
-SpanningTreeIterator::SpanningTreeIterator(const Graph& g) {
+SpanningTreeIterator::SpanningTreeIterator(const Graph& g, int root) {
     n = g.n;
     m = (int) 2 * g.edges.size();
-    r = 0;
+    r = root;
 
     edges.resize(m);
 
@@ -65,6 +66,12 @@ std::vector<int> SpanningTreeIterator::next() {
     return ans;
 }
 
+std::vector<int> SpanningTreeIterator::nextDirected() {
+    std::vector<int> ans = T;
+    advance();
+    return ans;
+}
+
 bool SpanningTreeIterator::isWDescendentOfV(int w, int v) {
     int start_v = lastTreeWalkStartTime[v];
     int end_v = lastTreeWalkEndTime[v];
@@ -72,16 +79,25 @@ bool SpanningTreeIterator::isWDescendentOfV(int w, int v) {
     return (start_v <= start_w && start_w <= end_v);
 }
 
+// numbers the vertices of the current tree in DFS order, with an explicit stack of
+// (vertex, index of the next child to visit)
 void SpanningTreeIterator::performNewTreeWalk() {
     int currentTime = 0;
-    std::function<void(int)> dfs = [&](int v) {
-        lastTreeWalkStartTime[v] = ++currentTime;
-        for (int u : tree[v]) {
-            dfs(u);
+    walkStack.clear();
+    walkStack.emplace_back(r, 0);
+    lastTreeWalkStartTime[r] = ++currentTime;
+    while (!walkStack.empty()) {
+        auto& [v, i] = walkStack.back();
+        if (i < (int) tree[v].size()) {
+            int u = tree[v][i++];
+            lastTreeWalkStartTime[u] = ++currentTime;
+            walkStack.emplace_back(u, 0);
         }
-        lastTreeWalkEndTime[v] = ++currentTime;
-    };
-    dfs(r);
+        else {
+            lastTreeWalkEndTime[v] = ++currentTime;
+            walkStack.pop_back();
+        }
+    }
 }
 
 void SpanningTreeIterator::advance() {
@@ -173,4 +189,44 @@ void SpanningTreeIterator::advance() {
     done = true;
 }
 
+long double countSpanningTrees(const Graph& g) {
+    if (g.n <= 1) return 1;
+
+    // Laplacian matrix of g without the row and column of vertex 0
+    int d = g.n - 1;
+    std::vector<std::vector<long double>> L(d, std::vector<long double>(d, 0));
+    for (auto [u, v] : g.edges) {
+        if (u == v) continue;
+        if (u > 0) L[u - 1][u - 1] += 1;
+        if (v > 0) L[v - 1][v - 1] += 1;
+        if (u > 0 && v > 0) {
+            L[u - 1][v - 1] -= 1;
+            L[v - 1][u - 1] -= 1;
+        }
+    }
+
+    // determinant by Gaussian elimination with partial pivoting
+    long double det = 1;
+    for (int i = 0; i < d; ++i) {
+        int pivot = i;
+        for (int j = i + 1; j < d; ++j) {
+            if (std::fabs(L[j][i]) > std::fabs(L[pivot][i])) pivot = j;
+        }
+        if (std::fabs(L[pivot][i]) < 1e-12L) return 0;
+        if (pivot != i) {
+            std::swap(L[pivot], L[i]);
+            det = -det;
+        }
+        det *= L[i][i];
+        for (int j = i + 1; j < d; ++j) {
+            long double factor = L[j][i] / L[i][i];
+            if (factor == 0) continue;
+            for (int k = i; k < d; ++k) {
+                L[j][k] -= factor * L[i][k];
+            }
+        }
+    }
+    return std::round(det);
+}
+
 } // namespace broadcast
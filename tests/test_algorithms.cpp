@@ -6,11 +6,18 @@
 #include <broadcast/utilities/generator.hpp>
 #include <broadcast/utilities/graph.hpp>
 #include <broadcast/utilities/protocol.hpp>
+#include <broadcast/utilities/solve_tree.hpp>
 
 #include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
 #include <functional>
 #include <random>
 #include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
 #include <vector>
 
 using namespace broadcast;
@@ -360,3 +367,392 @@ TEST_CASE("Broadcasting on many random large graphs", "[algorithm]") {
         }
     }
 }
+
+TEST_CASE("Broadcasting on graphs with interchangeable children", "[algorithm]") {
+    // complete bipartite graphs K_{2,m} with a few extra leaves, so that many
+    // vertices of U are leaves of the spanning trees of G2 with the same parent
+    std::mt19937 rng(31415926);
+    for (int m = 2; m <= 6; ++m) {
+        for (int cas = 1; cas <= 10; ++cas) {
+            Graph g{m + 2, 0, {}};
+            for (int i = 2; i < m + 2; ++i) {
+                g.edges.push_back({0, i});
+                g.edges.push_back({i, 1});
+            }
+            int numberOfLeaves = (int) (rng() % 4);
+            for (int i = 0; i < numberOfLeaves; ++i) {
+                g.edges.push_back({(int) (rng() % g.n), g.n});
+                g.n += 1;
+            }
+            REQUIRE(isSimpleAndConnected(g));
+
+            for (int s = 0; s < g.n; ++s) {
+                g.s = s;
+
+                BroadcastingProtocol bp1 = algorithmCyclomatic(g);
+                REQUIRE(isValidBroadcastingProtocol(bp1, g));
+
+                BroadcastingProtocol bp3 = algorithmEnumerateAllTrees(g);
+                REQUIRE(isValidBroadcastingProtocol(bp3, g));
+
+                REQUIRE(bp1.rounds.size() == bp3.rounds.size());
+            }
+        }
+    }
+}
+
+// complete bipartite graph K_{2,m}, where the edges from vertex 0 are replaced by
+// paths of the given length, with extra leaves attached to random vertices
+Graph bipartiteGraphWithLeaves(int m, int pathLength, int numberOfLeaves, std::mt19937& rng) {
+    Graph g{m + 2, 0, {}};
+    for (int i = 2; i < m + 2; ++i) {
+        int last = 0;
+        for (int j = 1; j < pathLength; ++j) {
+            g.edges.push_back({last, g.n});
+            last = g.n;
+            g.n += 1;
+        }
+        g.edges.push_back({last, i});
+        g.edges.push_back({i, 1});
+    }
+    for (int i = 0; i < numberOfLeaves; ++i) {
+        g.edges.push_back({(int) (rng() % g.n), g.n});
+        g.n += 1;
+    }
+    return g;
+}
+
+TEST_CASE("Broadcasting on graphs with leaf children of different needs", "[algorithm]") {
+    // the vertices 2, ..., m + 1 are leaves of many spanning trees of G2, whose xTrees
+    // need different times, so they are sent to in the order of their deadlines
+    std::mt19937 rng(27182818);
+    for (int m = 2; m <= 4; ++m) {
+        for (int cas = 1; cas <= 10; ++cas) {
+            Graph g = bipartiteGraphWithLeaves(m, 1, 12 - m - 2, rng);
+            REQUIRE(isSimpleAndConnected(g));
+
+            for (int s = 0; s < g.n; s += 3) {
+                g.s = s;
+
+                BroadcastingProtocol bp1 = algorithmCyclomatic(g);
+                REQUIRE(isValidBroadcastingProtocol(bp1, g));
+
+                BroadcastingProtocol bp2 = algorithmDP(g);
+                REQUIRE(isValidBroadcastingProtocol(bp2, g));
+
+                BroadcastingProtocol bp3 = algorithmEnumerateAllTrees(g);
+                REQUIRE(isValidBroadcastingProtocol(bp3, g));
+
+                REQUIRE(bp1.rounds.size() == bp2.rounds.size());
+                REQUIRE(bp1.rounds.size() == bp3.rounds.size());
+            }
+        }
+    }
+    for (int m = 5; m <= 7; ++m) {
+        for (int cas = 1; cas <= 10; ++cas) {
+            Graph g = bipartiteGraphWithLeaves(m, 1, (int) (rng() % 12), rng);
+            REQUIRE(isSimpleAndConnected(g));
+
+            for (int s = 0; s < g.n; ++s) {
+                g.s = s;
+
+                BroadcastingProtocol bp1 = algorithmCyclomatic(g);
+                REQUIRE(isValidBroadcastingProtocol(bp1, g));
+
+                BroadcastingProtocol bp3 = algorithmEnumerateAllTrees(g);
+                REQUIRE(isValidBroadcastingProtocol(bp3, g));
+
+                REQUIRE(bp1.rounds.size() == bp3.rounds.size());
+            }
+        }
+    }
+}
+
+TEST_CASE("Broadcasting on graphs with leaf children behind xyTrees", "[algorithm]") {
+    // the edges from vertex 0 to the vertices 2, ..., m + 1 become xyTrees, so these
+    // vertices are leaf children that are reached over an xyTree
+    std::mt19937 rng(16180339);
+    for (int m = 2; m <= 3; ++m) {
+        for (int pathLength = 2; pathLength <= 3; ++pathLength) {
+            for (int cas = 1; cas <= 10; ++cas) {
+                int numberOfLeaves = std::max(0, 12 - m * pathLength - 2);
+                Graph g = bipartiteGraphWithLeaves(m, pathLength, numberOfLeaves, rng);
+                REQUIRE(isSimpleAndConnected(g));
+
+                for (int s = 0; s < g.n; s += 3) {
+                    g.s = s;
+
+                    BroadcastingProtocol bp1 = algorithmCyclomatic(g);
+                    REQUIRE(isValidBroadcastingProtocol(bp1, g));
+
+                    BroadcastingProtocol bp2 = algorithmDP(g);
+                    REQUIRE(isValidBroadcastingProtocol(bp2, g));
+
+                    BroadcastingProtocol bp3 = algorithmEnumerateAllTrees(g);
+                    REQUIRE(isValidBroadcastingProtocol(bp3, g));
+
+                    REQUIRE(bp1.rounds.size() == bp2.rounds.size());
+                    REQUIRE(bp1.rounds.size() == bp3.rounds.size());
+                }
+            }
+        }
+    }
+    for (int m = 4; m <= 6; ++m) {
+        for (int cas = 1; cas <= 10; ++cas) {
+            int pathLength = 2 + (int) (rng() % 3);
+            Graph g = bipartiteGraphWithLeaves(m, pathLength, (int) (rng() % 16), rng);
+            REQUIRE(isSimpleAndConnected(g));
+
+            for (int s = 0; s < g.n; s += 2) {
+                g.s = s;
+
+                BroadcastingProtocol bp1 = algorithmCyclomatic(g);
+                REQUIRE(isValidBroadcastingProtocol(bp1, g));
+
+                BroadcastingProtocol bp3 = algorithmEnumerateAllTrees(g);
+                REQUIRE(isValidBroadcastingProtocol(bp3, g));
+
+                REQUIRE(bp1.rounds.size() == bp3.rounds.size());
+            }
+        }
+    }
+}
+
+TEST_CASE("Multi-threaded search returns the same protocol", "[algorithm]") {
+    int seed = 7142857;
+    for (int n = 10; n <= 60; n += 10) {
+        for (int k = 1; k <= 5; ++k) {
+            for (int cas = 1; cas <= 5; ++cas) {
+                Graph g = generateRandomGraph(n, k, seed);
+                seed += 1;
+
+                REQUIRE(isSimpleAndConnected(g));
+
+                BroadcastingProtocol bp1 = algorithmCyclomatic(g);
+                REQUIRE(isValidBroadcastingProtocol(bp1, g));
+
+                for (int numThreads : {2, 4}) {
+                    CyclomaticOptions options;
+                    options.numThreads = numThreads;
+                    BroadcastingProtocol bp2 = algorithmCyclomatic(g, options);
+                    REQUIRE(isValidBroadcastingProtocol(bp2, g));
+                    REQUIRE(bp1 == bp2);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Multi-threaded preprocessing returns the same protocol", "[algorithm]") {
+    // large enough that the first levels of the peeling are shared among the threads
+    int seed = 3141592;
+    for (int k = 1; k <= 3; ++k) {
+        Graph g = generateRandomGraph(100000, k, seed);
+        seed += 1;
+
+        BroadcastingProtocol bp1 = algorithmCyclomatic(g);
+        REQUIRE(isValidBroadcastingProtocol(bp1, g));
+
+        CyclomaticOptions options;
+        options.numThreads = 4;
+        BroadcastingProtocol bp2 = algorithmCyclomatic(g, options);
+        REQUIRE(bp1 == bp2);
+    }
+}
+
+TEST_CASE("Time limited search returns a valid protocol and report", "[algorithm]") {
+    int seed = 15092025;
+    for (int n = 10; n <= 60; n += 10) {
+        for (int k = 1; k <= 5; ++k) {
+            for (int cas = 1; cas <= 5; ++cas) {
+                Graph g = generateRandomGraph(n, k, seed);
+                seed += 1;
+
+                REQUIRE(isSimpleAndConnected(g));
+
+                CyclomaticReport report1;
+                BroadcastingProtocol bp1 = algorithmCyclomatic(g, CyclomaticOptions(), report1);
+                REQUIRE(isValidBroadcastingProtocol(bp1, g));
+                REQUIRE(report1.optimal);
+                REQUIRE(report1.rounds == (int) bp1.rounds.size());
+                REQUIRE(report1.lowerBound == report1.rounds);
+
+                CyclomaticOptions options;
+                options.timeLimit = 1e-9;
+                CyclomaticReport report2;
+                BroadcastingProtocol bp2 = algorithmCyclomatic(g, options, report2);
+                REQUIRE(isValidBroadcastingProtocol(bp2, g));
+                REQUIRE(report2.rounds == (int) bp2.rounds.size());
+                REQUIRE(report2.lowerBound <= report1.rounds);
+                REQUIRE(report2.rounds >= report1.rounds);
+                REQUIRE(report2.spanningTreesSearched <= report2.spanningTreesTotal);
+                if (report2.optimal) {
+                    REQUIRE(report2.rounds == report1.rounds);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Search estimate matches the search", "[algorithm]") {
+    int seed = 11062024;
+    for (int n = 10; n <= 60; n += 10) {
+        for (int k = 0; k <= 5; ++k) {
+            for (int cas = 1; cas <= 3; ++cas) {
+                Graph g = generateRandomGraph(n, k, seed);
+                seed += 1;
+
+                REQUIRE(isSimpleAndConnected(g));
+
+                CyclomaticReport report;
+                algorithmCyclomatic(g, CyclomaticOptions(), report);
+
+                CyclomaticEstimate estimate = estimateCyclomatic(g, CyclomaticOptions());
+                REQUIRE(estimate.spanningTreesTotal == report.spanningTreesTotal);
+                REQUIRE(estimate.lowerBound <= report.rounds);
+                REQUIRE(estimate.initialRounds >= report.rounds);
+                REQUIRE(estimate.rejectedShare >= 0);
+                REQUIRE(estimate.rejectedShare <= 1);
+                REQUIRE(estimate.predictedSearchTime >= 0);
+                if (estimate.initialRounds == estimate.lowerBound) {
+                    REQUIRE(estimate.spanningTreesSampled == 0);
+                    REQUIRE(estimate.predictedSearchTime == 0);
+                }
+                else {
+                    REQUIRE(estimate.spanningTreesSampled > 0);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Resumed search returns the same protocol", "[algorithm]") {
+    const char* checkpointFile = "test_algorithms_checkpoint.tmp";
+    int seed = 31415926;
+    int numberOfResumedSearches = 0;
+    for (int n = 20; n <= 60; n += 20) {
+        for (int k = 2; k <= 5; ++k) {
+            for (int cas = 1; cas <= 3; ++cas) {
+                Graph g = generateRandomGraph(n, k, seed);
+                seed += 1;
+
+                CyclomaticReport report1;
+                BroadcastingProtocol bp1 = algorithmCyclomatic(g, CyclomaticOptions(), report1);
+
+                // stop the first run after some trees, so that the second one skips
+                // them and starts from their incumbent. The limit is a multiple of the
+                // 16 trees a search thread takes at once, so that both runs search
+                // the trees in the same order
+                std::remove(checkpointFile);
+                CyclomaticOptions options;
+                options.checkpointFile = checkpointFile;
+                options.spanningTreeLimit = 32;
+                CyclomaticReport report;
+                algorithmCyclomatic(g, options, report);
+
+                std::ifstream in(checkpointFile);
+                std::string header;
+                uint64_t graphHash;
+                int shardIndex, numberOfShards;
+                long long treesDone = 0;
+                std::getline(in, header);
+                REQUIRE(in >> graphHash >> shardIndex >> numberOfShards >> treesDone);
+                // without any trees, the initial solution already meets the lower bound
+                REQUIRE(treesDone <= options.spanningTreeLimit);
+                if (report1.spanningTreesSearched > 0) {
+                    REQUIRE(treesDone > 0);
+                }
+                if (!report.searchCompleted) {
+                    REQUIRE(treesDone == options.spanningTreeLimit);
+                    numberOfResumedSearches += 1;
+                }
+
+                options.spanningTreeLimit = 0;
+                options.resume = true;
+                BroadcastingProtocol bp2 = algorithmCyclomatic(g, options, report);
+                REQUIRE(report.optimal);
+                REQUIRE(bp1 == bp2);
+                REQUIRE(report.treeIndex == report1.treeIndex);
+                REQUIRE(report.spanningTreesSearched == report1.spanningTreesSearched);
+            }
+        }
+    }
+    REQUIRE(numberOfResumedSearches > 0);
+
+    // a checkpoint of a different graph is rejected
+    Graph other = generateRandomGraph(30, 3, seed);
+    CyclomaticOptions options;
+    options.checkpointFile = checkpointFile;
+    options.resume = true;
+    REQUIRE_THROWS_AS(algorithmCyclomatic(other, options), std::runtime_error);
+    std::remove(checkpointFile);
+}
+
+TEST_CASE("Checkpoint of a different shard is rejected", "[algorithm]") {
+    const char* checkpointFile = "test_algorithms_shard_checkpoint.tmp";
+    Graph g = generateRandomGraph(40, 4, 16180339);
+
+    std::remove(checkpointFile);
+    CyclomaticOptions options;
+    options.checkpointFile = checkpointFile;
+    options.timeLimit = 1e-9;
+    options.shardIndex = 0;
+    options.numberOfShards = 2;
+    algorithmCyclomatic(g, options);
+
+    options.timeLimit = 0;
+    options.resume = true;
+    options.shardIndex = 1;
+    REQUIRE_THROWS_AS(algorithmCyclomatic(g, options), std::runtime_error);
+
+    options.shardIndex = 0;
+    options.numberOfShards = 1;
+    REQUIRE_THROWS_AS(algorithmCyclomatic(g, options), std::runtime_error);
+
+    // the same shard resumes
+    options.numberOfShards = 2;
+    CyclomaticReport report;
+    BroadcastingProtocol bp = algorithmCyclomatic(g, options, report);
+    REQUIRE(report.searchCompleted);
+    REQUIRE(isValidBroadcastingProtocol(bp, g));
+    std::remove(checkpointFile);
+}
+
+TEST_CASE("Sharded search merges into the same protocol", "[algorithm]") {
+    int seed = 27182818;
+    for (int n = 20; n <= 60; n += 20) {
+        for (int k = 1; k <= 5; ++k) {
+            for (int cas = 1; cas <= 3; ++cas) {
+                Graph g = generateRandomGraph(n, k, seed);
+                seed += 1;
+
+                CyclomaticReport report;
+                BroadcastingProtocol bp1 = algorithmCyclomatic(g, CyclomaticOptions(), report);
+
+                for (int numberOfShards : {2, 3}) {
+                    int bestRounds = -1;
+                    long long bestTreeIndex = -1;
+                    std::vector<int> bestRemoveEdges;
+                    for (int shard = 0; shard < numberOfShards; ++shard) {
+                        CyclomaticOptions options;
+                        options.shardIndex = shard;
+                        options.numberOfShards = numberOfShards;
+                        CyclomaticReport shardReport;
+                        BroadcastingProtocol bp = algorithmCyclomatic(g, options, shardReport);
+                        REQUIRE(isValidBroadcastingProtocol(bp, g));
+                        REQUIRE(shardReport.rounds >= report.rounds);
+                        if (bestRounds == -1 || std::make_pair(shardReport.rounds, shardReport.treeIndex)
+                                < std::make_pair(bestRounds, bestTreeIndex)) {
+                            bestRounds = shardReport.rounds;
+                            bestTreeIndex = shardReport.treeIndex;
+                            bestRemoveEdges = shardReport.removeEdges;
+                        }
+                    }
+                    REQUIRE(bestRounds == report.rounds);
+                    REQUIRE(bestTreeIndex == report.treeIndex);
+                    REQUIRE(solveOnTree(g, bestRemoveEdges) == bp1);
+                }
+            }
+        }
+    }
+}
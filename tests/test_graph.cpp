@@ -3,6 +3,7 @@
 #include <broadcast/utilities/graph.hpp>
 
 #include <sstream>
+#include <vector>
 
 using namespace broadcast;
 
@@ -56,6 +57,22 @@ TEST_CASE("Graph without vertices is invalid", "[graph]") {
     REQUIRE_FALSE(isSimpleAndConnected(g));
 }
 
+TEST_CASE("Adjacency lists in edge order", "[graph]") {
+    Graph g{4, 0, {{1, 0}, {1, 2}, {3, 1}, {1, 2}}};
+    Adjacency adj(g);
+    REQUIRE(adj.degree(0) == 1);
+    REQUIRE(adj.degree(1) == 4);
+    REQUIRE(adj.degree(2) == 2);
+    REQUIRE(adj.degree(3) == 1);
+
+    std::vector<std::pair<int, int>> entries;
+    for (auto [u, eid] : adj[1]) entries.emplace_back(u, eid);
+    REQUIRE(entries == std::vector<std::pair<int, int>>{{0, 0}, {2, 1}, {3, 2}, {2, 3}});
+    REQUIRE(adj[2][1] == std::make_pair(1, 3));
+    REQUIRE(isSimpleAndConnected(Graph{4, 0, {{1, 0}, {1, 2}, {3, 1}}}, Adjacency(Graph{4, 0, {{1, 0}, {1, 2}, {3, 1}}})));
+    REQUIRE_FALSE(isSimpleAndConnected(g, adj));
+}
+
 TEST_CASE("Graph read and write 1", "[graph][io]") {
     Graph g1{5, 0, {{1, 0}, {1, 2}, {1, 3}, {1, 4}, {2, 3}}};
     Graph g2{5, 0, {{1, 0}, {1, 2}, {1, 3}, {1, 4}, {3, 2}}};
@@ -79,3 +96,19 @@ TEST_CASE("Graph read and write 2", "[graph][io]") {
     Graph g_read = readGraph(input_stream);
     REQUIRE(g == g_read);
 }
+
+TEST_CASE("Graph hash recognizes equal graphs", "[graph]") {
+    Graph g1{5, 0, {{1,0}, {1,2}, {1, 3}, {1, 4}, {2, 3}}};
+    Graph g2{5, 0, {{1,0}, {1,2}, {1, 3}, {1, 4}, {2, 3}}};
+    REQUIRE(hashGraph(g1) == hashGraph(g2));
+}
+
+TEST_CASE("Graph hash distinguishes different graphs", "[graph]") {
+    Graph g{5, 0, {{1,0}, {1,2}, {1, 3}, {1, 4}, {2, 3}}};
+    Graph otherSource{5, 1, {{1,0}, {1,2}, {1, 3}, {1, 4}, {2, 3}}};
+    Graph otherEdge{5, 0, {{1,0}, {1,2}, {1, 3}, {1, 4}, {2, 4}}};
+    Graph otherOrder{5, 0, {{1,2}, {1,0}, {1, 3}, {1, 4}, {2, 3}}};
+    REQUIRE(hashGraph(g) != hashGraph(otherSource));
+    REQUIRE(hashGraph(g) != hashGraph(otherEdge));
+    REQUIRE(hashGraph(g) != hashGraph(otherOrder));
+}
@@ -0,0 +1,69 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <broadcast/algorithms/dp.hpp>
+#include <broadcast/utilities/generator.hpp>
+#include <broadcast/utilities/graph.hpp>
+#include <broadcast/utilities/lower_bounds.hpp>
+#include <broadcast/utilities/protocol.hpp>
+
+#include <algorithm>
+#include <vector>
+
+using namespace broadcast;
+
+TEST_CASE("Logarithmic lower bound", "[lower_bounds]") {
+    REQUIRE(logarithmicLowerBound(1) == 0);
+    REQUIRE(logarithmicLowerBound(2) == 1);
+    REQUIRE(logarithmicLowerBound(3) == 2);
+    REQUIRE(logarithmicLowerBound(4) == 2);
+    REQUIRE(logarithmicLowerBound(5) == 3);
+    REQUIRE(logarithmicLowerBound(1024) == 10);
+    REQUIRE(logarithmicLowerBound(1025) == 11);
+}
+
+TEST_CASE("Distances from source on line", "[lower_bounds]") {
+    Graph g{5, 2, {{0, 1}, {1, 2}, {2, 3}, {3, 4}}};
+    REQUIRE(distancesFromSource(g) == std::vector<int>{2, 1, 0, 1, 2});
+}
+
+TEST_CASE("Lower bound on single vertex", "[lower_bounds]") {
+    Graph g{1, 0, {}};
+    REQUIRE(broadcastingLowerBound(g) == 0);
+}
+
+TEST_CASE("Lower bound on line is the eccentricity", "[lower_bounds]") {
+    Graph g{10, 0, {{0, 1}, {1, 2}, {2, 3}, {3, 4}, {4, 5}, {5, 6}, {6, 7}, {7, 8}, {8, 9}}};
+    REQUIRE(broadcastingLowerBound(g) == 9);
+}
+
+TEST_CASE("Lower bound on star is logarithmic", "[lower_bounds]") {
+    Graph g{9, 0, {{0, 1}, {0, 2}, {0, 3}, {0, 4}, {0, 5}, {0, 6}, {0, 7}, {0, 8}}};
+    REQUIRE(broadcastingLowerBound(g) == 4);
+}
+
+TEST_CASE("Lower bound is tight on perfect broadcasting graphs", "[lower_bounds]") {
+    int seed = 4172025;
+    for (int n = 1; n <= 200; n += 7) {
+        for (int k = 0; k <= std::min(5, n * (n - 1) / 2 - n + 1); ++k) {
+            Graph g = generateRandomPerfectBroadcastingGraph(n, k, seed);
+            seed += 1;
+            REQUIRE(broadcastingLowerBound(g) == logarithmicLowerBound(n));
+        }
+    }
+}
+
+TEST_CASE("Lower bound does not exceed the optimum", "[lower_bounds]") {
+    int seed = 9182025;
+    for (int n = 2; n <= 10; ++n) {
+        for (int k = 0; k <= std::min(4, n * (n - 1) / 2 - n + 1); ++k) {
+            for (int cas = 1; cas <= 10; ++cas) {
+                Graph g = generateRandomGraph(n, k, seed);
+                seed += 1;
+
+                BroadcastingProtocol bp = algorithmDP(g);
+                REQUIRE(isValidBroadcastingProtocol(bp, g));
+                REQUIRE(broadcastingLowerBound(g) <= (int) bp.rounds.size());
+            }
+        }
+    }
+}
@@ -0,0 +1,95 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <broadcast/utilities/partial_result.hpp>
+
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+using namespace broadcast;
+
+PartialResult makePartialResult(int shardIndex, int numberOfShards, int rounds, long long treeIndex) {
+    PartialResult result;
+    result.graphHash = 123456789;
+    result.shardIndex = shardIndex;
+    result.numberOfShards = numberOfShards;
+    result.rounds = rounds;
+    result.treeIndex = treeIndex;
+    result.lowerBound = 3;
+    result.removeEdges = {shardIndex, 10 + shardIndex};
+    return result;
+}
+
+TEST_CASE("Print and read partial result", "[partial_result]") {
+    PartialResult result = makePartialResult(2, 5, 7, 42);
+    result.completed = false;
+    std::stringstream ss;
+    printPartialResult(result, ss);
+    REQUIRE(readPartialResult(ss) == result);
+}
+
+TEST_CASE("Read partial result without removed edges", "[partial_result]") {
+    std::stringstream ss("99\n0 1\n4 -1 4 1\n0\n");
+    PartialResult result = readPartialResult(ss);
+    REQUIRE(result.graphHash == 99);
+    REQUIRE(result.rounds == 4);
+    REQUIRE(result.treeIndex == -1);
+    REQUIRE(result.completed);
+    REQUIRE(result.removeEdges.empty());
+}
+
+TEST_CASE("Read malformed partial result", "[partial_result]") {
+    std::stringstream ss1("99\n3 3\n4 -1 4 1\n0\n");
+    REQUIRE_THROWS_AS(readPartialResult(ss1), std::runtime_error);
+    std::stringstream ss2("99\n0 1\n4 -1 4 1\n2 5\n");
+    REQUIRE_THROWS_AS(readPartialResult(ss2), std::runtime_error);
+    std::stringstream ss3("99\n0 1\n4 -1 4 1\n2 5 -1\n");
+    REQUIRE_THROWS_AS(readPartialResult(ss3), std::runtime_error);
+    std::stringstream ss4("99\n0 1\n4 -1 4 1\n2 5 5\n");
+    REQUIRE_THROWS_AS(readPartialResult(ss4), std::runtime_error);
+}
+
+TEST_CASE("Removed edges must fit the graph", "[partial_result]") {
+    // a cycle of four vertices with a chord, so two edges are removed
+    Graph g{4, 0, {{0, 1}, {1, 2}, {2, 3}, {3, 0}, {0, 2}}};
+    PartialResult result;
+    result.removeEdges = {1, 4};
+    REQUIRE_NOTHROW(checkRemoveEdges(result, g));
+
+    result.removeEdges = {1, 5000000};
+    REQUIRE_THROWS_AS(checkRemoveEdges(result, g), std::runtime_error);
+    result.removeEdges = {-1, 4};
+    REQUIRE_THROWS_AS(checkRemoveEdges(result, g), std::runtime_error);
+    result.removeEdges = {1};
+    REQUIRE_THROWS_AS(checkRemoveEdges(result, g), std::runtime_error);
+    result.removeEdges = {1, 2, 4};
+    REQUIRE_THROWS_AS(checkRemoveEdges(result, g), std::runtime_error);
+}
+
+TEST_CASE("Merge picks fewest rounds and then smallest tree index", "[partial_result]") {
+    std::vector<PartialResult> results = {
+        makePartialResult(0, 3, 8, 3),
+        makePartialResult(1, 3, 7, 13),
+        makePartialResult(2, 3, 7, 5),
+    };
+    results[1].lowerBound = 6;
+    PartialResult merged = mergePartialResults(results);
+    REQUIRE(merged.rounds == 7);
+    REQUIRE(merged.treeIndex == 5);
+    REQUIRE(merged.removeEdges == results[2].removeEdges);
+    REQUIRE(merged.lowerBound == 6);
+    REQUIRE(merged.completed);
+    REQUIRE(merged.numberOfShards == 1);
+}
+
+TEST_CASE("Merge rejects inconsistent shards", "[partial_result]") {
+    std::vector<PartialResult> missing = {makePartialResult(0, 3, 8, 3), makePartialResult(2, 3, 7, 5)};
+    REQUIRE_THROWS_AS(mergePartialResults(missing), std::runtime_error);
+
+    std::vector<PartialResult> twice = {makePartialResult(0, 2, 8, 3), makePartialResult(0, 2, 7, 5)};
+    REQUIRE_THROWS_AS(mergePartialResults(twice), std::runtime_error);
+
+    std::vector<PartialResult> otherGraph = {makePartialResult(0, 2, 8, 3), makePartialResult(1, 2, 7, 5)};
+    otherGraph[1].graphHash += 1;
+    REQUIRE_THROWS_AS(mergePartialResults(otherGraph), std::runtime_error);
+}
@@ -98,6 +98,15 @@ TEST_CASE("Invalid broadcasting protocol 8 (edge does not exist)", "[broadcast]"
     REQUIRE_FALSE(isValidBroadcastingProtocol(bp, g));
 }
 
+TEST_CASE("Invalid broadcasting protocol 9 (informed twice in one round)", "[broadcast]") {
+    Graph g{4, 0, {{0, 1}, {0, 2}, {1, 3}, {2, 3}}};
+    BroadcastingProtocol bp;
+    bp.rounds = {{{0, 1}}, {{0, 2}}, {{1, 3}, {2, 3}}};
+    REQUIRE_FALSE(isValidBroadcastingProtocol(bp, g));
+    bp.rounds = {{{0, 1}}, {{0, 2}, {1, 3}}};
+    REQUIRE(isValidBroadcastingProtocol(bp, g, Adjacency(g)));
+}
+
 TEST_CASE("Broadcasting Protocol read and write 1", "[protocol][io]") {
     BroadcastingProtocol bp1, bp2, bp3, bp4;
     bp1.rounds = {{{6, 1}}, {{1, 8}}, {{1, 2}, {8, 7}}, {{1, 0}, {2, 3}, {7, 5}, {8, 4}}};
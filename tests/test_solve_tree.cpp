@@ -92,6 +92,23 @@ TEST_CASE("Tree dp with ignored edges 2", "[tree_dp]") {
     REQUIRE((int) bp.rounds.size() == 7);
 }
 
+TEST_CASE("Tree dp does not depend on the order of the edges", "[tree_dp]") {
+    Graph g{10, 4, {
+        {4, 5},
+        {4, 2},
+        {2, 1},
+        {4, 0},
+        {0, 7},
+        {0, 6},
+        {7, 3},
+        {3, 9},
+        {8, 9}
+    }};
+    Graph reversed{10, 4, {g.edges.rbegin(), g.edges.rend()}};
+    for (auto& [u, v] : reversed.edges) std::swap(u, v);
+    REQUIRE(solveOnTree(g) == solveOnTree(reversed));
+}
+
 TEST_CASE("Tree dp on graph with cycle", "[tree_dp]") {
     Graph g{10, 4, {
         {4, 5},
@@ -262,3 +262,69 @@ TEST_CASE("Spanning trees on many random medium size multi-graphs", "[spanning_t
         }
     }
 }
+
+TEST_CASE("Counting spanning trees of complete graphs", "[spanning_trees]") {
+    // Cayley's formula: n^(n-2) spanning trees
+    for (int n = 1; n <= 9; ++n) {
+        Graph g{n, 0, {}};
+        for (int u = 0; u < n; ++u) {
+            for (int v = u + 1; v < n; ++v) {
+                g.edges.emplace_back(u, v);
+            }
+        }
+        long double expected = 1;
+        for (int i = 0; i < n - 2; ++i) expected *= n;
+        REQUIRE(countSpanningTrees(g) == expected);
+    }
+}
+
+TEST_CASE("Counting spanning trees on many random multi-graphs", "[spanning_trees]") {
+    int seed = 7122025;
+    for (int n = 1; n <= 12; ++n) {
+        for (int k = 0; k <= 6; ++k) {
+            for (int cas = 1; cas <= 5; ++cas) {
+                Graph g = generateRandomMultiGraph(n, k, seed);
+                seed += 1;
+                REQUIRE(countSpanningTrees(g) == (long double) getAllSpanningTrees(g).size());
+            }
+        }
+    }
+}
+
+TEST_CASE("Directed spanning trees from every root on random multi-graphs", "[spanning_trees]") {
+    int seed = 19062024;
+    for (int n = 1; n <= 8; ++n) {
+        for (int k = 0; k <= 5; ++k) {
+            for (int cas = 1; cas <= 5; ++cas) {
+                Graph g = generateRandomMultiGraph(n, k, seed);
+                seed += 1;
+                std::vector<std::vector<int>> expected = getAllSpanningTrees(g);
+
+                for (int root = 0; root < n; ++root) {
+                    std::vector<std::vector<int>> trees;
+                    SpanningTreeIterator iter(g, root);
+                    while (iter.hasNext()) {
+                        std::vector<int> T = iter.nextDirected();
+                        REQUIRE((int) T.size() == n - 1);
+
+                        // every edge starts at the root or at the end of an earlier edge
+                        std::vector<bool> reached(n, false);
+                        reached[root] = true;
+                        for (int& a : T) {
+                            auto [u, v] = g.edges[a / 2];
+                            if (a % 2 == 1) std::swap(u, v);
+                            REQUIRE(reached[u]);
+                            REQUIRE(!reached[v]);
+                            reached[v] = true;
+                            a /= 2;
+                        }
+                        std::sort(T.begin(), T.end());
+                        trees.push_back(T);
+                    }
+                    std::sort(trees.begin(), trees.end());
+                    REQUIRE(trees == expected);
+                }
+            }
+        }
+    }
+}